@@ -0,0 +1,476 @@
+#ifndef __ANNEALER_H__
+#define __ANNEALER_H__
+
+#include <vector>
+#include <string>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <cmath>
+#include <limits>
+#include <functional>
+
+#include "PolishExpression.h"
+#include "MoveSelection.h"
+#include "PerfProfiler.h"
+#include "MoveTrace.h"
+#include "ParetoArchive.h"
+
+/*
+* Type for the annealing run configuration
+* (tuning variables listed in the README)
+*/
+typedef struct annealConfig_t
+{
+    // Cool down rate when generating bad moves
+    float tempScaling = 0.9f;
+    // Lowest temperature to anneal till
+    float tempConstraint = 10.0f;
+    // Time out for annealing (minutes)
+    float timeOut = 5;
+    // Iteration scaling per run (k in the pseudo code)
+    int runMultiplier = 5000;
+    // Starting temperature
+    float initialTemperature = 1000;
+    // Seed for the random number generators (0 => random device)
+    unsigned int seed = 0;
+    // Print the cost after every temperature step
+    bool verbose = true;
+    // Draw the acceptance threshold first and stop evaluating moves proven above it
+    bool boundedEvaluation = true;
+    // Stop once a legal floorplan has at most this whitespace fraction (0 => run the full schedule)
+    float whitespaceTarget = 0;
+} annealConfig_t;
+
+/*
+* Type for one point of the best cost over time curve
+*/
+typedef struct costSample_t
+{
+    // Seconds since the start of the run
+    double time;
+    float bestCost;
+} costSample_t;
+
+/*
+* Type for the result of an annealing run
+*/
+typedef struct annealResult_t
+{
+    std::vector<std::string> bestExpression;
+    float initialCost = 0;
+    float bestCost = 0;
+    // Number of temperature steps run
+    int attempts = 0;
+    // Number of successful moves evaluated
+    long long movesTried = 0;
+    // Wall time of the anneal in seconds
+    double runTime = 0;
+    // Per move type statistics (index 0 is move type 1)
+    std::vector<moveStats_t> moveStats;
+    // Stopped early on the whitespace target
+    bool targetMet = false;
+    // Best cost at the start and after every temperature step
+    std::vector<costSample_t> costCurve;
+} annealResult_t;
+
+/*
+* Cost policy: area of the floorplan (+ outline penalty when the state has a fixed outline)
+*/
+class AreaCost
+{
+private:
+    float whitespaceTarget;
+
+public:
+    explicit AreaCost(const annealConfig_t& inConfig) : whitespaceTarget(inConfig.whitespaceTarget) {}
+
+    template <typename Representation>
+    float operator()(Representation& inState) { return inState.compute_area(); }
+
+    // Exact below costBound, any value above costBound otherwise
+    template <typename Representation>
+    float operator()(Representation& inState, float costBound) { return inState.compute_bounded_area(costBound); }
+
+    /*
+    * Function to check if a new best state ends the run
+    * @param inState -> state with cost inCost
+    * @param inCost -> cost of the state
+    * @return bool if the chip fits the outline with at most whitespaceTarget whitespace
+    *
+    * NOTE: cost >= chip area => states above the module area / (1 - target) are
+    * rejected without placing the modules
+    */
+    template <typename Representation>
+    bool is_target_met(Representation& inState, float inCost)
+    {
+        if (this->whitespaceTarget <= 0 ||
+            inCost > inState.get_module_store().total_area() / (1 - this->whitespaceTarget))
+        {
+            return false;
+        }
+        const fixedOutline_t& outline = inState.get_outline();
+        if (!is_outline_active(outline))
+        {
+            return true;
+        }
+        float chipWidth, chipHeight;
+        inState.compute_chip_size(chipWidth, chipHeight);
+        return chipWidth <= outline.width && chipHeight <= outline.height;
+    }
+};
+
+/*
+* Cooling policy: geometric cool down T <- TempScaling * T
+*/
+class GeometricCooling
+{
+private:
+    float tempScaling;
+
+public:
+    explicit GeometricCooling(const annealConfig_t& inConfig) : tempScaling(inConfig.tempScaling) {}
+
+    float operator()(float inTemp) const { return this->tempScaling * inTemp; }
+};
+
+/*
+* Simulated annealing driver
+*
+* Policies are resolved at compile time so each combination is a
+* specialised loop with no virtual dispatch.
+*
+* Representation needs:
+*   state_t, moveTypeCount, save_state(), restore_state(), apply_move(),
+*   get_polish_expression(), get_module_count(), get_move_module_count(), set_seed(),
+*   get_last_move() (move traces), get_module_store(), get_outline(), compute_chip_size() (AreaCost target,
+*   Pareto archive)
+* CostPolicy needs: CostPolicy(const annealConfig_t&), float operator()(Representation&),
+*   float operator()(Representation&, float costBound) (exact below the bound),
+*   bool is_target_met(Representation&, float cost) (stops the run on a new best state)
+* CoolingPolicy needs: CoolingPolicy(const annealConfig_t&), float operator()(float)
+* RandomEngine: any std random number engine
+* MovePolicy needs: MovePolicy(int moveTypeCount), int select(float, float, int),
+*   record(), end_step(), get_stats() (ScheduledMoves / AdaptiveMoves)
+*/
+template <typename Representation, typename CostPolicy = AreaCost,
+    typename CoolingPolicy = GeometricCooling, typename RandomEngine = std::default_random_engine,
+    typename MovePolicy = ScheduledMoves>
+class Annealer
+{
+public:
+
+    /*
+    * Hook called after every temperature step
+    * @param state -> current state (can be replaced, currCost must then be updated)
+    * @param currCost -> cost of the current state
+    * @param bestState -> best state so far
+    * @param bestCost -> cost of the best state
+    * @param step -> temperature step number
+    */
+    typedef std::function<void(Representation& state, float& currCost,
+        const typename Representation::state_t& bestState, float bestCost, int step)> stepHook_t;
+
+private:
+    // Expression being annealed (updated in place)
+    Representation& state;
+    annealConfig_t config;
+    CostPolicy costPolicy;
+    CoolingPolicy coolingPolicy;
+    RandomEngine randGenerator;
+    MovePolicy movePolicy;
+    // Optional hardware counter profiler (NULL => not profiled)
+    PerfProfiler* profiler;
+    // Optional move trace (NULL => not recorded)
+    MoveTraceWriter* traceWriter;
+    // Optional hook after each temperature step (empty => none)
+    stepHook_t stepHook;
+    // Optional archive of the non-dominated accepted states (NULL => none)
+    ParetoArchive* paretoArchive;
+
+public:
+
+    /*
+    * Constructor
+    * @param inState -> expression to anneal, holds best solution after run
+    * @param inConfig -> run configuration
+    */
+    Annealer(Representation& inState, const annealConfig_t& inConfig)
+        : state(inState), config(inConfig), costPolicy(inConfig), coolingPolicy(inConfig),
+        movePolicy(Representation::moveTypeCount)
+    {
+        this->profiler = NULL;
+        this->traceWriter = NULL;
+        this->paretoArchive = NULL;
+        if (this->config.seed != 0)
+        {
+            this->randGenerator.seed(this->config.seed);
+            // Different stream for the moves
+            this->state.set_seed(this->config.seed + 1);
+        }
+        else
+        {
+            std::random_device rd;
+            this->randGenerator.seed(rd());
+        }
+    }
+
+    /*
+    * Getter for the cost policy (to read policy specific data after run)
+    */
+    CostPolicy& get_cost_policy() { return this->costPolicy; }
+
+    /*
+    * Getter for the move policy
+    */
+    MovePolicy& get_move_policy() { return this->movePolicy; }
+
+    /*
+    * Setter for the hardware counter profiler (must be created on the calling thread)
+    * @param inProfiler -> profiler measuring the move, evaluation and rollback phases
+    */
+    void set_profiler(PerfProfiler* inProfiler) { this->profiler = inProfiler; }
+
+    /*
+    * Setter for the move trace writer
+    * @param inTraceWriter -> writer recording every move, decision and evaluation bound
+    */
+    void set_trace_writer(MoveTraceWriter* inTraceWriter) { this->traceWriter = inTraceWriter; }
+
+    /*
+    * Setter for the step hook (e.g. migration between islands)
+    * @param inStepHook -> function called after each temperature step
+    */
+    void set_step_hook(const stepHook_t& inStepHook) { this->stepHook = inStepHook; }
+
+    /*
+    * Setter for the Pareto archive
+    * @param inParetoArchive -> archive offered the start state and every accepted state
+    */
+    void set_pareto_archive(ParetoArchive* inParetoArchive) { this->paretoArchive = inParetoArchive; }
+
+    /*
+    * Function to run the annealing
+    * @return result of the run, state is left at the best solution
+    */
+    annealResult_t run();
+};
+
+/*
+* Function to run the annealing
+* @return result of the run, state is left at the best solution
+*
+* Logic: Current cost is carried across moves (only the new state is evaluated),
+* rejected moves restore the state saved before the move
+*
+* Bounded evaluation: exp(-delCost / T) > u <=> newCost < currCost - T * ln(u), so with u
+* drawn before the move the largest accepted cost is known and the evaluation
+* can stop as soon as the cost is proven above it (most moves at low temperature)
+*/
+template <typename Representation, typename CostPolicy, typename CoolingPolicy, typename RandomEngine,
+    typename MovePolicy>
+annealResult_t Annealer<Representation, CostPolicy, CoolingPolicy, RandomEngine, MovePolicy>::run()
+{
+    annealResult_t result;
+    std::uniform_int_distribution<int> percentDistribution(0, 99);
+    std::uniform_real_distribution<float> unitDistribution(0.0f, 1.0f);
+    std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+
+    typename Representation::state_t currState, bestState;
+    float currCost = this->costPolicy(this->state);
+    float bestCost = currCost;
+    this->state.save_state(bestState);
+    result.initialCost = currCost;
+    result.costCurve.push_back({ 0, currCost });
+    if (this->traceWriter)
+    {
+        this->traceWriter->write_header(this->state);
+    }
+    if (this->paretoArchive)
+    {
+        this->paretoArchive->offer(this->state);
+    }
+
+    // Moves per temperature scale with the modules the moves can touch
+    int maxRuns = this->config.runMultiplier * this->state.get_move_module_count();
+    float temperature = this->config.initialTemperature;
+    float runTime = 0;
+    int movesTried = 0, uphill = 0, reject = 0;
+    // Single module in the move window => M1 cannot run, no operator to move
+    bool canMove = this->state.get_module_count() > 1 && this->state.get_move_module_count() > 1;
+
+    while (canMove)
+    {
+        movesTried = 0;
+        uphill = 0;
+        reject = 0;
+        do
+        {
+            int moveType = this->movePolicy.select(temperature, this->config.initialTemperature,
+                percentDistribution(this->randGenerator));
+            std::chrono::steady_clock::time_point moveStart = std::chrono::steady_clock::now();
+            if (this->profiler)
+            {
+                this->profiler->begin_phase();
+            }
+            this->state.save_state(currState);
+            bool isApplied = this->state.apply_move(moveType);
+            if (this->profiler)
+            {
+                this->profiler->end_phase(moveType, PHASE_MOVE);
+            }
+            // if move attempt failed
+            if (isApplied == false)
+            {
+                this->movePolicy.record(moveType, false, false, 0, std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now() - moveStart).count());
+                if (this->traceWriter)
+                {
+                    this->traceWriter->record_move(moveType, false, false, -1, -1, 0);
+                }
+                continue; // re-attempt move
+            }
+            ++movesTried;
+            // Compute change in cost
+            float newCost, delCost;
+            float costBound = std::numeric_limits<float>::infinity();
+            bool isAccepted;
+            if (this->config.boundedEvaluation)
+            {
+                // u = 0 => no bound (always accepted)
+                float costThreshold = currCost - temperature * std::log(unitDistribution(this->randGenerator));
+                costBound = costThreshold;
+                if (this->profiler)
+                {
+                    this->profiler->begin_phase();
+                }
+                newCost = this->costPolicy(this->state, costThreshold);
+                if (this->profiler)
+                {
+                    this->profiler->end_phase(moveType, PHASE_EVAL);
+                }
+                delCost = newCost - currCost;
+                isAccepted = (delCost <= 0) || (newCost < costThreshold);
+            }
+            else
+            {
+                if (this->profiler)
+                {
+                    this->profiler->begin_phase();
+                }
+                newCost = this->costPolicy(this->state);
+                if (this->profiler)
+                {
+                    this->profiler->end_phase(moveType, PHASE_EVAL);
+                }
+                delCost = newCost - currCost;
+                isAccepted = (delCost <= 0) || (unitDistribution(this->randGenerator) < std::exp((-1 * delCost) / temperature));
+            }
+            if (isAccepted)
+            {
+                if (delCost > 0)
+                {
+                    ++uphill;
+                }
+                currCost = newCost;
+                if (this->paretoArchive)
+                {
+                    this->paretoArchive->offer(this->state);
+                }
+                // Check if the solution is global best one so far
+                if (newCost < bestCost)
+                {
+                    this->state.save_state(bestState);
+                    bestCost = newCost;
+                    result.targetMet = this->costPolicy.is_target_met(this->state, bestCost);
+                }
+            }
+            else
+            {
+                // Reject move
+                ++reject;
+                // Reset the polish expression
+                if (this->profiler)
+                {
+                    this->profiler->begin_phase();
+                }
+                this->state.restore_state(currState);
+                if (this->profiler)
+                {
+                    this->profiler->end_phase(moveType, PHASE_ROLLBACK);
+                }
+            }
+            this->movePolicy.record(moveType, true, isAccepted, delCost, std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - moveStart).count());
+            if (this->traceWriter)
+            {
+                int index1, index2;
+                this->state.get_last_move(index1, index2);
+                this->traceWriter->record_move(moveType, true, isAccepted, index1, index2, costBound);
+            }
+        } while ((uphill < maxRuns) && (movesTried < 2 * maxRuns) && !result.targetMet);
+
+        // Update temperature
+        temperature = this->coolingPolicy(temperature);
+        this->movePolicy.end_step();
+        if (this->traceWriter)
+        {
+            this->traceWriter->record_step();
+        }
+        if (this->stepHook)
+        {
+            this->stepHook(this->state, currCost, bestState, bestCost, result.attempts + 1);
+            // Hook may bring in a better state
+            if (currCost < bestCost)
+            {
+                this->state.save_state(bestState);
+                bestCost = currCost;
+                result.targetMet = this->costPolicy.is_target_met(this->state, bestCost);
+            }
+        }
+        if (this->profiler)
+        {
+            this->profiler->end_step(result.attempts + 1);
+        }
+        result.movesTried += movesTried;
+        ++result.attempts;
+        if (this->config.verbose)
+        {
+            std::cout << "Attempt #" << result.attempts << ": Cost Value = " << bestCost << "\n";
+        }
+
+        // Calcuate runtime for time out check
+        runTime = std::chrono::duration<float>(std::chrono::steady_clock::now() - startTime).count();
+        result.costCurve.push_back({ runTime, bestCost });
+        if (result.targetMet ||
+            ((float)reject / movesTried >= 0.95f) ||
+            (temperature <= this->config.tempConstraint) ||
+            (runTime >= 60 * this->config.timeOut))
+        {
+            break;
+        }
+    }
+
+    this->state.restore_state(bestState);
+    if (this->traceWriter)
+    {
+        this->traceWriter->finish(bestCost);
+    }
+    result.bestExpression = this->state.get_polish_expression();
+    result.bestCost = bestCost;
+    result.moveStats = this->movePolicy.get_stats();
+    result.runTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    return result;
+}
+
+/*
+* Default instantiation: area only slicing floorplan
+*/
+typedef Annealer<PolishExpression> SlicingAnnealer;
+
+/*
+* Slicing floorplan with move types picked by their observed improvement rate
+*/
+typedef Annealer<PolishExpression, AreaCost, GeometricCooling, std::default_random_engine, AdaptiveMoves> AdaptiveSlicingAnnealer;
+
+#endif // !__ANNEALER_H__
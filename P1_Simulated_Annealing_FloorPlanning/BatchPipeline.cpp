@@ -0,0 +1,221 @@
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <memory>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <set>
+
+#include "BatchPipeline.h"
+#include "BoundedQueue.h"
+#include "ThreadPool.h"
+#include "Floorplanner.h"
+#include "ModuleParser.h"
+
+/*
+* Type for one job moving through the pipeline
+*/
+typedef struct batchJob_t
+{
+    // Line number in the batch file (1 based), names the output files
+    int jobNumber = 0;
+    runOptions_t options;
+    std::vector<cirModule_t> moduleList;
+    // Set by a stage that fails (job is passed on to be reported)
+    std::string errorMessage;
+    // Anneal output
+    std::unique_ptr<PolishExpression> expression;
+    floorplanResult_t result;
+    std::string log;
+} batchJob_t;
+
+typedef std::unique_ptr<batchJob_t> batchJobPtr_t;
+
+/*
+* Function to parse the jobs of the batch file (parse stage)
+* @param jobLines -> batch file lines
+* @param defaultOptions -> options every job starts from
+* @param parsedQueue -> queue to the anneal workers, closed at the end
+*/
+static void parse_stage(const std::vector<std::vector<std::string> >& jobLines, const runOptions_t& defaultOptions,
+    BoundedQueue<batchJobPtr_t>& parsedQueue)
+{
+    // Files written by a job, two jobs must not write the same one
+    std::set<std::string> outputFileSet;
+    for (size_t i = 0; i < jobLines.size(); ++i)
+    {
+        batchJobPtr_t currJob(new batchJob_t());
+        currJob->jobNumber = (int)i + 1;
+        currJob->options = defaultOptions;
+        currJob->options.batchFile.clear();
+        currJob->options.config.verbose = false;
+        // Parallelism comes from the workers, one thread per job unless asked
+        currJob->options.threadCount = 1;
+        currJob->options.speculativeMoves = 1;
+        std::string invalidReason;
+        if (!parse_run_options(jobLines[i], currJob->options, true))
+        {
+            currJob->errorMessage = "invalid options";
+        }
+        else if (!validate_job_options(currJob->options, JOBSOURCE_BATCH, invalidReason))
+        {
+            currJob->errorMessage = "invalid options: " + invalidReason;
+        }
+        else if ((!currJob->options.traceRecordFile.empty() && !outputFileSet.insert(currJob->options.traceRecordFile).second) ||
+            (!currJob->options.paretoFile.empty() && !outputFileSet.insert(currJob->options.paretoFile).second))
+        {
+            // e.g. --trace-record in the default options of every job
+            currJob->errorMessage = "output file written by another job";
+        }
+        else
+        {
+            // Anything thrown here would end the parse thread and the whole batch
+            try
+            {
+                if (!read_module_file(currJob->options.inputFile, currJob->moduleList))
+                {
+                    currJob->errorMessage = "invalid module file " + currJob->options.inputFile;
+                }
+            }
+            catch (const std::exception& parseError)
+            {
+                currJob->errorMessage = std::string("parse failed: ") + parseError.what();
+            }
+        }
+        parsedQueue.push(std::move(currJob));
+    }
+    parsedQueue.close();
+}
+
+/*
+* Function to floorplan parsed jobs until the parse stage is done (anneal stage, one per worker)
+* @param parsedQueue -> jobs from the parse stage
+* @param doneQueue -> queue to the serialize stage
+*/
+static void anneal_stage(BoundedQueue<batchJobPtr_t>& parsedQueue, BoundedQueue<batchJobPtr_t>& doneQueue)
+{
+    batchJobPtr_t currJob;
+    while (parsedQueue.pop(currJob))
+    {
+        if (currJob->errorMessage.empty())
+        {
+            std::ostringstream logStream;
+            currJob->expression.reset(new PolishExpression());
+            try
+            {
+                currJob->result = run_floorplan(*currJob->expression, std::move(currJob->moduleList), currJob->options, logStream);
+                if (currJob->result.isValid)
+                {
+                    // Placement for the output (compute stays off the serialize stage)
+                    currJob->expression->compute_area(true);
+                }
+            }
+            catch (const std::exception& runError)
+            {
+                // Other jobs go on (e.g. bad_alloc of one huge design)
+                currJob->result.isValid = false;
+                logStream << "Floorplan failed: " << runError.what() << "\n";
+            }
+            currJob->log = logStream.str();
+            if (!currJob->result.isValid)
+            {
+                currJob->errorMessage = "invalid job input";
+            }
+        }
+        doneQueue.push(std::move(currJob));
+    }
+}
+
+/*
+* Function to write the finished jobs (serialize stage)
+* @param batchFile -> batch file, prefix of the output files
+* @param doneQueue -> jobs from the anneal workers
+* @param failedCount -> number of failed jobs
+*/
+static void serialize_stage(const std::string& batchFile, BoundedQueue<batchJobPtr_t>& doneQueue, int& failedCount)
+{
+    batchJobPtr_t currJob;
+    while (doneQueue.pop(currJob))
+    {
+        std::string outputPrefix = batchFile + "." + std::to_string(currJob->jobNumber);
+        if (currJob->errorMessage.empty())
+        {
+            std::ofstream OUTFH(outputPrefix + ".out");
+            if (!OUTFH.is_open())
+            {
+                currJob->errorMessage = "unable to open " + outputPrefix + ".out";
+            }
+            else
+            {
+                OUTFH << currJob->log;
+                currJob->expression->print_modules(OUTFH);
+                OUTFH << "Best polish expression found:\n";
+                for (auto& element : currJob->expression->get_polish_expression())
+                {
+                    OUTFH << element << " ";
+                }
+                OUTFH << "\nBest area: " << currJob->result.chipArea;
+                if (currJob->result.chipArea != currJob->result.bestCost)
+                {
+                    OUTFH << " (penalized cost " << currJob->result.bestCost << ")";
+                }
+                OUTFH << "\n";
+                currJob->expression->generate_plot_file(outputPrefix + ".plot");
+            }
+        }
+        if (!currJob->errorMessage.empty())
+        {
+            ++failedCount;
+            std::cout << "Job " << currJob->jobNumber << ": error " << currJob->errorMessage << "\n";
+        }
+        else
+        {
+            std::cout << "Job " << currJob->jobNumber << ": " << currJob->options.inputFile << " " << currJob->result.solver
+                << " area " << currJob->result.chipArea << " in " << currJob->result.runTime << "s -> "
+                << outputPrefix << ".out\n";
+        }
+        // Expression freed here, off the workers
+        currJob.reset();
+    }
+}
+
+/*
+* Function to run a list of floorplan jobs through a three stage pipeline
+* @param batchFile -> job list, one command line per line: <input_file> [options]
+* @param defaultOptions -> options every job starts from (threadCount => anneal workers)
+* @return bool if the job list could be read and every job succeeded
+*/
+bool run_batch(const std::string& batchFile, const runOptions_t& defaultOptions)
+{
+    std::vector<std::vector<std::string> > jobLines;
+    if (!read_split_lines(batchFile, jobLines))
+    {
+        return false;
+    }
+    std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+
+    BoundedQueue<batchJobPtr_t> parsedQueue(BATCHQUEUEDEPTH);
+    BoundedQueue<batchJobPtr_t> doneQueue(BATCHQUEUEDEPTH);
+    int failedCount = 0;
+    std::thread serializeThread(serialize_stage, std::cref(batchFile), std::ref(doneQueue), std::ref(failedCount));
+    std::thread parseThread(parse_stage, std::cref(jobLines), std::cref(defaultOptions), std::ref(parsedQueue));
+    int workerCount;
+    {
+        ThreadPool workerPool(defaultOptions.threadCount);
+        workerCount = workerPool.size();
+        for (int w = 0; w < workerCount; ++w)
+        {
+            workerPool.submit([&parsedQueue, &doneQueue]() { anneal_stage(parsedQueue, doneQueue); });
+        }
+        // Pool joins once the parse stage closed its queue and every job is annealed
+    }
+    parseThread.join();
+    doneQueue.close();
+    serializeThread.join();
+
+    std::cout << "Batch: " << jobLines.size() << " jobs (" << failedCount << " failed) on " << workerCount << " workers in "
+        << std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count() << "s\n";
+    return failedCount == 0;
+}
@@ -0,0 +1,29 @@
+#ifndef __BATCH_PIPELINE_H__
+#define __BATCH_PIPELINE_H__
+
+#include <string>
+
+#include "RunOptions.h"
+
+/*
+* Batch pipeline constraints
+*/
+// Jobs buffered between two stages (parsed ahead / waiting for output)
+#define BATCHQUEUEDEPTH 4
+
+/*
+* Function to run a list of floorplan jobs through a three stage pipeline
+* @param batchFile -> job list, one command line per line: <input_file> [options]
+* @param defaultOptions -> options every job starts from (threadCount => anneal workers)
+* @return bool if the job list could be read and every job succeeded
+*
+* Stages (connected by BoundedQueue of BATCHQUEUEDEPTH jobs):
+*   parse:     one thread reading the module files ahead of the workers
+*   anneal:    threadCount workers of a ThreadPool, one job each at a time
+*   serialize: one thread writing <batch_file>.<n>.out (modules, expression, area)
+*              and <batch_file>.<n>.plot (plot data) for job n and one summary line to stdout
+* so reading and writing files overlaps the anneals. Summary lines are in completion order.
+*/
+bool run_batch(const std::string& batchFile, const runOptions_t& defaultOptions);
+
+#endif // !__BATCH_PIPELINE_H__
@@ -0,0 +1,391 @@
+
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <thread>
+#include <stdexcept>
+
+#include "Benchmark.h"
+#include "ThreadPool.h"
+#include "Floorplanner.h"
+#include "ModuleParser.h"
+
+/*
+* Type for one design of the corpus
+*/
+typedef struct benchDesign_t
+{
+    std::string inputFile;
+    // Area the time to target is measured for (0 => from the best final area)
+    double targetArea = 0;
+    std::vector<cirModule_t> moduleList;
+} benchDesign_t;
+
+/*
+* Type for one engine / schedule to compare
+*/
+typedef struct benchEngine_t
+{
+    std::string name;
+    runOptions_t options;
+} benchEngine_t;
+
+/*
+* Type for one run (design x engine x seed)
+*/
+typedef struct benchRun_t
+{
+    int designIndex = 0;
+    int engineIndex = 0;
+    unsigned int seed = 0;
+    floorplanResult_t result;
+    // Seconds to the first sample at or below the target area (< 0 => not reached)
+    double timeToTarget = -1;
+} benchRun_t;
+
+/*
+* Type for the statistics of a sample
+*/
+typedef struct benchStats_t
+{
+    int count = 0;
+    double minValue = 0;
+    double median = 0;
+    double mean = 0;
+    double maxValue = 0;
+    double stddev = 0;
+} benchStats_t;
+
+/*
+* Function to compute the statistics of a sample
+* @param values -> sample (sorted in place)
+* @return statistics, count 0 for an empty sample
+*/
+static benchStats_t sample_stats(std::vector<double>& values)
+{
+    benchStats_t stats;
+    stats.count = (int)values.size();
+    if (values.empty())
+    {
+        return stats;
+    }
+    std::sort(values.begin(), values.end());
+    size_t middle = values.size() / 2;
+    stats.minValue = values.front();
+    stats.maxValue = values.back();
+    stats.median = (values.size() % 2) ? values[middle] : (values[middle - 1] + values[middle]) / 2;
+    for (double value : values)
+    {
+        stats.mean += value;
+    }
+    stats.mean /= values.size();
+    for (double value : values)
+    {
+        stats.stddev += (value - stats.mean) * (value - stats.mean);
+    }
+    stats.stddev = std::sqrt(stats.stddev / values.size());
+    return stats;
+}
+
+/*
+* Function to read the benchmark file
+* @param benchFile -> benchmark file (seeds / design / engine lines)
+* @param defaultOptions -> options every engine starts from
+* @param outDesignList -> designs with their modules
+* @param outEngineList -> engines (default options if the file has none)
+* @param outSeedCount -> seeds per design and engine
+* @return bool if the file and every design are valid
+*/
+static bool read_benchmark_file(const std::string& benchFile, const runOptions_t& defaultOptions,
+    std::vector<benchDesign_t>& outDesignList, std::vector<benchEngine_t>& outEngineList, int& outSeedCount)
+{
+    std::vector<std::vector<std::string> > benchLines;
+    if (!read_split_lines(benchFile, benchLines))
+    {
+        return false;
+    }
+    // One thread per run unless the engine asks for more
+    runOptions_t baseOptions = defaultOptions;
+    baseOptions.benchmarkFile.clear();
+    baseOptions.config.verbose = false;
+    baseOptions.threadCount = 1;
+    outSeedCount = BENCHSEEDS;
+    for (auto& currLine : benchLines)
+    {
+        if (currLine[0] == "seeds" && currLine.size() == 2)
+        {
+            try
+            {
+                outSeedCount = std::stoi(currLine[1]);
+            }
+            catch (const std::logic_error&)
+            {
+                outSeedCount = 0;
+            }
+            if (outSeedCount < 1)
+            {
+                std::cerr << "Benchmark needs at least one seed, got " << currLine[1] << "\n";
+                return false;
+            }
+        }
+        else if (currLine[0] == "design" && (currLine.size() == 2 || currLine.size() == 3))
+        {
+            benchDesign_t currDesign;
+            currDesign.inputFile = currLine[1];
+            if (currLine.size() == 3)
+            {
+                try
+                {
+                    currDesign.targetArea = std::stod(currLine[2]);
+                }
+                catch (const std::logic_error&)
+                {
+                    currDesign.targetArea = -1;
+                }
+                if (!(currDesign.targetArea > 0))
+                {
+                    std::cerr << "Invalid target area " << currLine[2] << " of design " << currDesign.inputFile << "\n";
+                    return false;
+                }
+            }
+            if (!read_module_file(currDesign.inputFile, currDesign.moduleList))
+            {
+                return false;
+            }
+            outDesignList.push_back(std::move(currDesign));
+        }
+        else if (currLine[0] == "engine" && currLine.size() >= 2)
+        {
+            benchEngine_t currEngine;
+            currEngine.name = currLine[1];
+            currEngine.options = baseOptions;
+            std::vector<std::string> args(currLine.begin() + 2, currLine.end());
+            if (!parse_run_options(args, currEngine.options, false))
+            {
+                std::cerr << "Invalid options of engine " << currEngine.name << "\n";
+                return false;
+            }
+            outEngineList.push_back(currEngine);
+        }
+        else
+        {
+            std::cerr << "Invalid benchmark line starting with " << currLine[0] << "\n";
+            return false;
+        }
+    }
+    if (outEngineList.empty())
+    {
+        benchEngine_t currEngine;
+        currEngine.name = "default";
+        currEngine.options = baseOptions;
+        outEngineList.push_back(currEngine);
+    }
+    for (auto& currEngine : outEngineList)
+    {
+        std::string invalidReason;
+        if (!validate_job_options(currEngine.options, JOBSOURCE_BENCHMARK, invalidReason))
+        {
+            std::cerr << "Engine " << currEngine.name << ": " << invalidReason << "\n";
+            return false;
+        }
+    }
+    if (outDesignList.empty())
+    {
+        std::cerr << "Benchmark file has no design\n";
+        return false;
+    }
+    return true;
+}
+
+/*
+* Function to compare engines and schedules by quality of result over runtime
+* @param benchFile -> benchmark file, one entry per line:
+*                     seeds <n>
+*                     design <input_file> [<target_area>]
+*                     engine <name> [options]
+* @param defaultOptions -> options every engine starts from (threadCount => cores of the benchmark)
+* @return bool if the benchmark file was valid and every run succeeded
+*/
+bool run_benchmark(const std::string& benchFile, const runOptions_t& defaultOptions)
+{
+    std::vector<benchDesign_t> designList;
+    std::vector<benchEngine_t> engineList;
+    int seedCount = BENCHSEEDS;
+    if (!read_benchmark_file(benchFile, defaultOptions, designList, engineList, seedCount))
+    {
+        return false;
+    }
+    unsigned int baseSeed = (defaultOptions.config.seed != 0) ? defaultOptions.config.seed : 1;
+    std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+
+    // Same seeds for every engine => paired comparison
+    std::vector<benchRun_t> runList;
+    for (int d = 0; d < (int)designList.size(); ++d)
+    {
+        for (int e = 0; e < (int)engineList.size(); ++e)
+        {
+            for (int s = 0; s < seedCount; ++s)
+            {
+                benchRun_t currRun;
+                currRun.designIndex = d;
+                currRun.engineIndex = e;
+                currRun.seed = baseSeed + (unsigned int)s;
+                runList.push_back(currRun);
+            }
+        }
+    }
+    // Fixed core budget per run: concurrent runs never share the cores of a multi threaded engine
+    int coreCount = (defaultOptions.threadCount > 0) ? defaultOptions.threadCount :
+        (int)std::max(1u, std::thread::hardware_concurrency());
+    int engineThreads = 1;
+    for (auto& currEngine : engineList)
+    {
+        int threadCount = (currEngine.options.threadCount > 0) ? currEngine.options.threadCount :
+            (int)std::max(1u, std::thread::hardware_concurrency());
+        engineThreads = std::max(engineThreads, std::max(threadCount, currEngine.options.speculativeMoves));
+    }
+    int parallelRuns = std::max(1, coreCount / engineThreads);
+    {
+        ThreadPool workerPool(parallelRuns);
+        for (auto& currRun : runList)
+        {
+            benchRun_t* runPtr = &currRun;
+            workerPool.submit([runPtr, &designList, &engineList]()
+            {
+                runOptions_t runOptions = engineList[runPtr->engineIndex].options;
+                runOptions.config.seed = runPtr->seed;
+                std::ostringstream logStream;
+                PolishExpression currPolishExpression;
+                runPtr->result = run_floorplan(currPolishExpression, designList[runPtr->designIndex].moduleList,
+                    runOptions, logStream);
+            });
+        }
+        // Pool joins every run
+    }
+
+    // Default targets: best area any engine reached on the design
+    int failedCount = 0;
+    std::vector<float> bestAreaList(designList.size(), std::numeric_limits<float>::max());
+    for (auto& currRun : runList)
+    {
+        if (!currRun.result.isValid)
+        {
+            ++failedCount;
+            continue;
+        }
+        bestAreaList[currRun.designIndex] = std::min(bestAreaList[currRun.designIndex], currRun.result.bestCost);
+    }
+    for (size_t d = 0; d < designList.size(); ++d)
+    {
+        if (designList[d].targetArea <= 0)
+        {
+            designList[d].targetArea = bestAreaList[d] * (1 + (double)BENCHTARGETSLACK);
+        }
+    }
+    for (auto& currRun : runList)
+    {
+        double targetArea = designList[currRun.designIndex].targetArea;
+        for (auto& currSample : currRun.result.costCurve)
+        {
+            if (currSample.bestCost <= targetArea)
+            {
+                currRun.timeToTarget = currSample.time;
+                break;
+            }
+        }
+    }
+
+    std::ofstream RUNFH(benchFile + ".runs.csv");
+    std::ofstream CURVEFH(benchFile + ".curves.csv");
+    std::ofstream SUMMARYFH(benchFile + ".summary.csv");
+    if (!RUNFH.is_open() || !CURVEFH.is_open() || !SUMMARYFH.is_open())
+    {
+        std::cerr << "Unable to open the benchmark output files " << benchFile << ".*.csv\n";
+        return false;
+    }
+    RUNFH << std::setprecision(9);
+    CURVEFH << std::setprecision(9);
+    SUMMARYFH << std::setprecision(9);
+    RUNFH << "design,engine,seed,solver,initial_area,final_area,setup_s,runtime_s,time_to_target_s\n";
+    CURVEFH << "design,engine,seed,time_s,best_area\n";
+    SUMMARYFH << "design,engine,runs,target_area,reached,time_to_target_median_s,time_to_target_mean_s,"
+        << "area_min,area_median,area_mean,area_max,area_stddev,runtime_mean_s\n";
+    for (auto& currRun : runList)
+    {
+        const std::string& designName = designList[currRun.designIndex].inputFile;
+        const std::string& engineName = engineList[currRun.engineIndex].name;
+        if (!currRun.result.isValid)
+        {
+            std::cout << designName << " " << engineName << " seed " << currRun.seed << ": invalid run\n";
+            continue;
+        }
+        RUNFH << designName << "," << engineName << "," << currRun.seed << "," << currRun.result.solver << ","
+            << currRun.result.initialCost << "," << currRun.result.bestCost << "," << currRun.result.setupTime << ","
+            << currRun.result.setupTime + currRun.result.runTime << ",";
+        if (currRun.timeToTarget >= 0)
+        {
+            RUNFH << currRun.timeToTarget;
+        }
+        RUNFH << "\n";
+        for (auto& currSample : currRun.result.costCurve)
+        {
+            CURVEFH << designName << "," << engineName << "," << currRun.seed << "," << currSample.time << ","
+                << currSample.bestCost << "\n";
+        }
+    }
+
+    // Runs are grouped by design, then engine
+    for (size_t first = 0; first < runList.size(); first += seedCount)
+    {
+        std::vector<double> areaList, targetTimeList, runTimeList;
+        for (size_t i = first; i < first + seedCount; ++i)
+        {
+            if (!runList[i].result.isValid)
+            {
+                continue;
+            }
+            areaList.push_back(runList[i].result.bestCost);
+            runTimeList.push_back(runList[i].result.setupTime + runList[i].result.runTime);
+            if (runList[i].timeToTarget >= 0)
+            {
+                targetTimeList.push_back(runList[i].timeToTarget);
+            }
+        }
+        const benchDesign_t& currDesign = designList[runList[first].designIndex];
+        const std::string& engineName = engineList[runList[first].engineIndex].name;
+        benchStats_t areaStats = sample_stats(areaList);
+        benchStats_t targetTimeStats = sample_stats(targetTimeList);
+        benchStats_t runTimeStats = sample_stats(runTimeList);
+        SUMMARYFH << currDesign.inputFile << "," << engineName << "," << areaStats.count << "," << currDesign.targetArea << ","
+            << targetTimeStats.count << ",";
+        if (targetTimeStats.count > 0)
+        {
+            SUMMARYFH << targetTimeStats.median << "," << targetTimeStats.mean;
+        }
+        else
+        {
+            SUMMARYFH << ",";
+        }
+        SUMMARYFH << "," << areaStats.minValue << "," << areaStats.median << "," << areaStats.mean << "," << areaStats.maxValue
+            << "," << areaStats.stddev << "," << runTimeStats.mean << "\n";
+
+        std::cout << currDesign.inputFile << " " << engineName << ": target " << currDesign.targetArea << " reached "
+            << targetTimeStats.count << "/" << areaStats.count;
+        if (targetTimeStats.count > 0)
+        {
+            std::cout << " (median " << targetTimeStats.median << "s)";
+        }
+        std::cout << ", area median " << areaStats.median << " [" << areaStats.minValue << ", " << areaStats.maxValue
+            << "], runtime mean " << runTimeStats.mean << "s\n";
+    }
+
+    std::cout << "Benchmark: " << designList.size() << " designs x " << engineList.size() << " engines x " << seedCount
+        << " seeds, " << parallelRuns << " at a time (" << failedCount << " failed) in " << std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count()
+        << "s -> " << benchFile << ".runs.csv, .curves.csv, .summary.csv\n";
+    return failedCount == 0;
+}
@@ -0,0 +1,39 @@
+#ifndef __BENCHMARK_H__
+#define __BENCHMARK_H__
+
+#include <string>
+
+#include "RunOptions.h"
+
+/*
+* Benchmark constraints
+*/
+// Seeds per design and engine unless the benchmark file sets them
+#define BENCHSEEDS 5
+// Target area without an explicit one: best final area of the design (all engines) + this fraction
+#define BENCHTARGETSLACK 0.01
+
+/*
+* Function to compare engines and schedules by quality of result over runtime
+* @param benchFile -> benchmark file, one entry per line:
+*                     seeds <n>
+*                     design <input_file> [<target_area>]
+*                     engine <name> [options]
+* @param defaultOptions -> options every engine starts from (threadCount => cores of the benchmark)
+* @return bool if the benchmark file was valid and every run succeeded
+*
+* Every engine floorplans every design with the same seeds (config seed or 1, +1 per run),
+* runs spread over a ThreadPool of cores / most threads of one engine (--threads, --speculate;
+* one thread per run unless the engine sets them), so every run has the same core budget.
+* Without engine lines the default options are the only engine. Runs keep the best cost
+* after each temperature step from the start of the initial expression construction, from
+* which the time to the target area is read. Writes
+*   <bench_file>.runs.csv:    one line per run (final area, setup time, runtime, time to target)
+*   <bench_file>.curves.csv:  best area over time of every run
+*   <bench_file>.summary.csv: per design and engine target hit rate, time to target
+*                             median/mean and final area min/median/mean/max/stddev
+* and prints the summary.
+*/
+bool run_benchmark(const std::string& benchFile, const runOptions_t& defaultOptions);
+
+#endif // !__BENCHMARK_H__
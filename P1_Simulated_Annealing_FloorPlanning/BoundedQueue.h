@@ -0,0 +1,85 @@
+#ifndef __BOUNDED_QUEUE_H__
+#define __BOUNDED_QUEUE_H__
+
+#include <queue>
+#include <mutex>
+#include <condition_variable>
+
+/*
+* FIFO queue between pipeline stages holding at most capacity items
+* (producers block while it is full, consumers while it is empty)
+*/
+template <typename T>
+class BoundedQueue
+{
+private:
+    std::queue<T> itemQueue;
+    size_t capacity;
+    std::mutex queueMutex;
+    std::condition_variable notFullCondition;
+    std::condition_variable notEmptyCondition;
+    bool isClosed;
+
+public:
+
+    /*
+    * Constructor
+    * @param inCapacity -> maximum number of queued items (at least 1)
+    */
+    explicit BoundedQueue(size_t inCapacity) : capacity(inCapacity > 0 ? inCapacity : 1), isClosed(false) {}
+
+    BoundedQueue(const BoundedQueue&) = delete;
+    BoundedQueue& operator=(const BoundedQueue&) = delete;
+
+    /*
+    * Function to add an item, waits while the queue is full
+    * @param inItem -> item to add
+    * @return bool if added (false once the queue is closed)
+    */
+    bool push(T inItem)
+    {
+        std::unique_lock<std::mutex> queueLock(this->queueMutex);
+        this->notFullCondition.wait(queueLock, [this]() { return this->isClosed || this->itemQueue.size() < this->capacity; });
+        if (this->isClosed)
+        {
+            return false;
+        }
+        this->itemQueue.push(std::move(inItem));
+        this->notEmptyCondition.notify_one();
+        return true;
+    }
+
+    /*
+    * Function to take the oldest item, waits while the queue is empty
+    * @param outItem -> item taken
+    * @return bool if an item was taken (false once closed and drained)
+    */
+    bool pop(T& outItem)
+    {
+        std::unique_lock<std::mutex> queueLock(this->queueMutex);
+        this->notEmptyCondition.wait(queueLock, [this]() { return this->isClosed || !this->itemQueue.empty(); });
+        if (this->itemQueue.empty())
+        {
+            return false;
+        }
+        outItem = std::move(this->itemQueue.front());
+        this->itemQueue.pop();
+        this->notFullCondition.notify_one();
+        return true;
+    }
+
+    /*
+    * Function to close the queue: no more pushes, consumers drain the remaining items
+    */
+    void close()
+    {
+        {
+            std::lock_guard<std::mutex> queueLock(this->queueMutex);
+            this->isClosed = true;
+        }
+        this->notFullCondition.notify_all();
+        this->notEmptyCondition.notify_all();
+    }
+};
+
+#endif // !__BOUNDED_QUEUE_H__
@@ -0,0 +1,515 @@
+
+#include <iostream>
+#include <algorithm>
+#include <unordered_map>
+
+#include "EcoFloorplan.h"
+#include "ModuleParser.h"
+#include "HelperFuncs.h"
+
+/*
+* Type for the nodes of the slicing tree edited by the ECO
+*/
+typedef struct ecoNode_t
+{
+    std::string token;
+    int child1;
+    int child2;
+    int parent;
+    // Bounding box of the subtree
+    float width;
+    float height;
+    bool isAlive;
+} ecoNode_t;
+
+/*
+* Function to get the node list of a tree in post-order
+* @param nodeList -> tree nodes
+* @param root -> root node
+* @param outOrder -> node indices in post-order
+*/
+static void emit_postfix(const std::vector<ecoNode_t>& nodeList, int root, std::vector<int>& outOrder)
+{
+    outOrder.clear();
+    if (root == -1)
+    {
+        return;
+    }
+    // Iterative to support deep (chained) trees: (node, children pushed)
+    std::vector<std::pair<int, bool> > nodeStack;
+    nodeStack.push_back(std::make_pair(root, false));
+    while (!nodeStack.empty())
+    {
+        std::pair<int, bool> currEntry = nodeStack.back();
+        nodeStack.pop_back();
+        const ecoNode_t& currNode = nodeList[currEntry.first];
+        if (currEntry.second || currNode.child1 == -1)
+        {
+            outOrder.push_back(currEntry.first);
+            continue;
+        }
+        nodeStack.push_back(std::make_pair(currEntry.first, true));
+        nodeStack.push_back(std::make_pair(currNode.child2, false));
+        nodeStack.push_back(std::make_pair(currNode.child1, false));
+    }
+}
+
+/*
+* Function to compute the bounding box of a room from its children
+* @param nodeList -> tree nodes
+* @param index -> room node
+*/
+static void update_box(std::vector<ecoNode_t>& nodeList, int index)
+{
+    ecoNode_t& currNode = nodeList[index];
+    const ecoNode_t& module1 = nodeList[currNode.child1];
+    const ecoNode_t& module2 = nodeList[currNode.child2];
+    if (is_vertical_partition(currNode.token))
+    {
+        currNode.width = module1.width + module2.width;
+        currNode.height = std::max(module1.height, module2.height);
+    }
+    else // H_t
+    {
+        currNode.width = std::max(module1.width, module2.width);
+        currNode.height = module1.height + module2.height;
+    }
+}
+
+/*
+* Function to replace a child of a node
+* @param nodeList -> tree nodes
+* @param parent -> parent node (-1 => root)
+* @param oldChild -> child to replace
+* @param newChild -> child to put in place
+* @param root -> root of the tree, updated if parent is -1
+*/
+static void replace_child(std::vector<ecoNode_t>& nodeList, int parent, int oldChild, int newChild, int& root)
+{
+    nodeList[newChild].parent = parent;
+    if (parent == -1)
+    {
+        root = newChild;
+    }
+    else if (nodeList[parent].child1 == oldChild)
+    {
+        nodeList[parent].child1 = newChild;
+    }
+    else
+    {
+        nodeList[parent].child2 = newChild;
+    }
+}
+
+/*
+* Function to read a polish expression saved from the sa output
+* @param inputFile -> file holding the expression
+* @param outExpression -> expression tokens
+* @return bool if an expression was found
+*
+* NOTE: If the file holds a full sa log, the line after
+* "Best polish expression found:" is used, else the first line
+*/
+bool read_expression_file(const std::string& inputFile, std::vector<std::string>& outExpression)
+{
+    std::vector<std::vector<std::string> > lineList;
+    if (!read_split_lines(inputFile, lineList) || lineList.empty())
+    {
+        std::cerr << "No polish expression found in " << inputFile << "\n";
+        return false;
+    }
+    size_t expressionLine = 0;
+    for (size_t i = 0; i + 1 < lineList.size(); ++i)
+    {
+        std::string currLine;
+        for (auto& x : lineList[i])
+        {
+            currLine += x + " ";
+        }
+        if (currLine.find("Best polish expression found:") != std::string::npos)
+        {
+            expressionLine = i + 1;
+        }
+    }
+    outExpression = lineList[expressionLine];
+    return true;
+}
+
+/*
+* Function to read the module delta file
+* @param inputFile -> file to read
+* @param outDelta -> changes in file order
+* @return bool if the file is valid
+*/
+bool read_delta_file(const std::string& inputFile, std::vector<moduleDelta_t>& outDelta)
+{
+    std::vector<std::vector<std::string> > lineList;
+    if (!read_split_lines(inputFile, lineList))
+    {
+        return false;
+    }
+    for (auto& currentLineVec : lineList)
+    {
+        moduleDelta_t currDelta;
+        currDelta.action = str_to_lower(currentLineVec[0]);
+        if (currDelta.action == "remove" && currentLineVec.size() == 2)
+        {
+            currDelta.module.name = currentLineVec[1];
+        }
+        else if ((currDelta.action == "add" || currDelta.action == "update") &&
+            parse_module_fields(currentLineVec, 1, currDelta.module))
+        {
+            // Module fields parsed
+        }
+        else
+        {
+            std::cerr << "Incorrect format for delta file: expected add/update <module line> or remove <module_name>\n";
+            return false;
+        }
+        outDelta.push_back(currDelta);
+    }
+    return true;
+}
+
+/*
+* Function to apply the module delta to the module list
+* @param moduleList -> modules to update
+* @param delta -> changes to apply
+* @return bool if all changes refer to valid modules
+*/
+bool apply_module_delta(std::vector<cirModule_t>& moduleList, const std::vector<moduleDelta_t>& delta)
+{
+    for (auto& currDelta : delta)
+    {
+        std::vector<cirModule_t>::iterator currModule = moduleList.begin();
+        while (currModule != moduleList.end() && currModule->name != currDelta.module.name)
+        {
+            ++currModule;
+        }
+        bool isPresent = currModule != moduleList.end();
+        if (currDelta.action == "add" && !isPresent)
+        {
+            moduleList.push_back(currDelta.module);
+        }
+        else if (currDelta.action == "update" && isPresent)
+        {
+            *currModule = currDelta.module;
+        }
+        else if (currDelta.action == "remove" && isPresent)
+        {
+            moduleList.erase(currModule);
+        }
+        else
+        {
+            std::cerr << "Cannot " << currDelta.action << " module " << currDelta.module.name
+                << (isPresent ? ": already present\n" : ": not present\n");
+            return false;
+        }
+    }
+    return true;
+}
+
+/*
+* Function to patch the previous expression for the changed modules
+* @param ioExpression -> expression holding the updated modules, set to the patched expression
+* @param previousExpression -> best expression of the previous run
+* @param delta -> changes applied to the modules
+* @param outWindowBegin -> start of the expression range around the changes
+* @param outWindowEnd -> end (exclusive) of the expression range around the changes
+* @return bool if the previous expression is valid
+*
+* Logic: Removed modules are cut out of the slicing tree (sibling takes the place
+* of the parent), new modules are paired with the node giving the least area,
+* the tree is normalized (skewed) again and the window is the union of the
+* subtrees of at least ECOWINDOWLEAVES modules around each change.
+*/
+bool patch_expression(PolishExpression& ioExpression, const std::vector<std::string>& previousExpression,
+    const std::vector<moduleDelta_t>& delta, int& outWindowBegin, int& outWindowEnd)
+{
+    const ModuleStore& moduleStore = ioExpression.get_module_store();
+    std::vector<ecoNode_t> nodeList;
+    nodeList.reserve(previousExpression.size() + 2 * moduleStore.size());
+    std::unordered_map<std::string, int> leafNodes;
+    // Nodes around which the moves are needed
+    std::vector<int> affectedNodes;
+    int root = -1;
+
+    // Build the slicing tree of the previous expression
+    std::vector<int> nodeStack;
+    for (auto& currElement : previousExpression)
+    {
+        ecoNode_t currNode;
+        currNode.token = currElement;
+        currNode.child1 = currNode.child2 = currNode.parent = -1;
+        currNode.isAlive = true;
+        int index = (int)nodeList.size();
+        if (is_operator(currElement))
+        {
+            if (nodeStack.size() < 2)
+            {
+                std::cerr << "Invalid previous polish expression: operator " << currElement << " without 2 operands\n";
+                return false;
+            }
+            currNode.child2 = nodeStack.back();
+            nodeStack.pop_back();
+            currNode.child1 = nodeStack.back();
+            nodeStack.pop_back();
+            nodeList.push_back(currNode);
+            nodeList[currNode.child1].parent = index;
+            nodeList[currNode.child2].parent = index;
+            update_box(nodeList, index);
+        }
+        else
+        {
+            if (leafNodes.count(currElement) != 0)
+            {
+                std::cerr << "Invalid previous polish expression: module " << currElement << " repeated\n";
+                return false;
+            }
+            int id = moduleStore.find_id(currElement);
+            currNode.width = (id == -1) ? 0 : moduleStore.width(id);
+            currNode.height = (id == -1) ? 0 : moduleStore.height(id);
+            leafNodes[currElement] = index;
+            nodeList.push_back(currNode);
+        }
+        nodeStack.push_back(index);
+    }
+    if (nodeStack.size() != 1)
+    {
+        std::cerr << "Invalid previous polish expression: " << nodeStack.size() << " trees left\n";
+        return false;
+    }
+    root = nodeStack.back();
+
+    // Cut out the removed modules (not in module store anymore)
+    for (auto& currLeaf : leafNodes)
+    {
+        if (moduleStore.find_id(currLeaf.first) != -1)
+        {
+            continue;
+        }
+        int leaf = currLeaf.second;
+        int parent = nodeList[leaf].parent;
+        nodeList[leaf].isAlive = false;
+        if (parent == -1)
+        {
+            root = -1;
+            continue;
+        }
+        int sibling = (nodeList[parent].child1 == leaf) ? nodeList[parent].child2 : nodeList[parent].child1;
+        nodeList[parent].isAlive = false;
+        replace_child(nodeList, nodeList[parent].parent, parent, sibling, root);
+        affectedNodes.push_back(sibling);
+        // Update the boxes up to the root
+        for (int i = nodeList[sibling].parent; i != -1; i = nodeList[i].parent)
+        {
+            update_box(nodeList, i);
+        }
+    }
+
+    // Modules with changed data
+    for (auto& currDelta : delta)
+    {
+        std::unordered_map<std::string, int>::iterator currLeaf = leafNodes.find(currDelta.module.name);
+        if (currDelta.action == "update" && currLeaf != leafNodes.end() && nodeList[currLeaf->second].isAlive)
+        {
+            int leaf = currLeaf->second;
+            int id = moduleStore.find_id(currDelta.module.name);
+            nodeList[leaf].width = moduleStore.width(id);
+            nodeList[leaf].height = moduleStore.height(id);
+            affectedNodes.push_back(leaf);
+            for (int i = nodeList[leaf].parent; i != -1; i = nodeList[i].parent)
+            {
+                update_box(nodeList, i);
+            }
+        }
+    }
+
+    // Pair each new module (not in previous expression) with the best node
+    std::vector<int> postOrder;
+    for (int id = 0; id < moduleStore.size(); ++id)
+    {
+        std::string currName(moduleStore.name(id));
+        std::unordered_map<std::string, int>::iterator currLeaf = leafNodes.find(currName);
+        if (currLeaf != leafNodes.end() && nodeList[currLeaf->second].isAlive)
+        {
+            continue;
+        }
+        ecoNode_t newLeaf;
+        newLeaf.token = currName;
+        newLeaf.child1 = newLeaf.child2 = newLeaf.parent = -1;
+        newLeaf.width = moduleStore.width(id);
+        newLeaf.height = moduleStore.height(id);
+        newLeaf.isAlive = true;
+        int leaf = (int)nodeList.size();
+        nodeList.push_back(newLeaf);
+        leafNodes[currName] = leaf;
+        affectedNodes.push_back(leaf);
+        if (root == -1)
+        {
+            root = leaf;
+            continue;
+        }
+
+        // Area of the root if the box of node changes to (width, height)
+        // Logic: only the boxes on the path to the root change
+        emit_postfix(nodeList, root, postOrder);
+        size_t candidateStep = std::max((size_t)1, postOrder.size() / ECOINSERTCANDIDATES);
+        float bestArea = -1;
+        int bestNode = root;
+        std::string bestOp = V_t;
+        for (size_t c = 0; c < postOrder.size(); c += candidateStep)
+        {
+            int candidate = postOrder[c];
+            for (int o = 0; o < 2; ++o)
+            {
+                bool isVertical = (o == 0);
+                const ecoNode_t& candidateNode = nodeList[candidate];
+                float width = isVertical ? candidateNode.width + newLeaf.width : std::max(candidateNode.width, newLeaf.width);
+                float height = isVertical ? std::max(candidateNode.height, newLeaf.height) : candidateNode.height + newLeaf.height;
+                int child = candidate;
+                for (int i = candidateNode.parent; i != -1; i = nodeList[i].parent)
+                {
+                    const ecoNode_t& currNode = nodeList[i];
+                    const ecoNode_t& otherNode = nodeList[(currNode.child1 == child) ? currNode.child2 : currNode.child1];
+                    if (is_vertical_partition(currNode.token))
+                    {
+                        width = width + otherNode.width;
+                        height = std::max(height, otherNode.height);
+                    }
+                    else
+                    {
+                        width = std::max(width, otherNode.width);
+                        height = height + otherNode.height;
+                    }
+                    child = i;
+                }
+                if (bestArea < 0 || width * height < bestArea)
+                {
+                    bestArea = width * height;
+                    bestNode = candidate;
+                    bestOp = isVertical ? V_t : H_t;
+                }
+            }
+        }
+        // Insert room (bestNode newLeaf bestOp) in place of bestNode
+        ecoNode_t newRoom;
+        newRoom.token = bestOp;
+        newRoom.child1 = bestNode;
+        newRoom.child2 = leaf;
+        newRoom.isAlive = true;
+        int room = (int)nodeList.size();
+        nodeList.push_back(newRoom);
+        replace_child(nodeList, nodeList[bestNode].parent, bestNode, room, root);
+        nodeList[bestNode].parent = room;
+        nodeList[leaf].parent = room;
+        for (int i = room; i != -1; i = nodeList[i].parent)
+        {
+            update_box(nodeList, i);
+        }
+    }
+    if (root == -1)
+    {
+        std::cerr << "No modules left after the delta\n";
+        return false;
+    }
+
+    // Normalize: right child cannot have the same operator as the parent
+    // (x (r1 r2 o) o) => ((x r1 o) r2 o), r needs a re-check after the rotation
+    emit_postfix(nodeList, root, postOrder);
+    std::vector<int> fixList;
+    for (int index : postOrder)
+    {
+        fixList.push_back(index);
+        while (!fixList.empty())
+        {
+            int currIndex = fixList.back();
+            fixList.pop_back();
+            while (nodeList[currIndex].child2 != -1 && nodeList[nodeList[currIndex].child2].token == nodeList[currIndex].token)
+            {
+                int rotated = nodeList[currIndex].child2;
+                int module1 = nodeList[currIndex].child1;
+                int rotated1 = nodeList[rotated].child1;
+                int rotated2 = nodeList[rotated].child2;
+                nodeList[rotated].child1 = module1;
+                nodeList[rotated].child2 = rotated1;
+                nodeList[module1].parent = rotated;
+                nodeList[rotated1].parent = rotated;
+                nodeList[currIndex].child1 = rotated;
+                nodeList[currIndex].child2 = rotated2;
+                nodeList[rotated2].parent = currIndex;
+                update_box(nodeList, rotated);
+                fixList.push_back(rotated);
+            }
+        }
+    }
+
+    // Emit the patched expression
+    emit_postfix(nodeList, root, postOrder);
+    std::vector<std::string> patchedExpression;
+    std::vector<int> nodePosition(nodeList.size(), -1);
+    patchedExpression.reserve(postOrder.size());
+    for (size_t i = 0; i < postOrder.size(); ++i)
+    {
+        patchedExpression.push_back(nodeList[postOrder[i]].token);
+        nodePosition[postOrder[i]] = (int)i;
+    }
+    ioExpression.update_expression(patchedExpression);
+
+    // Window: subtree of at least ECOWINDOWLEAVES modules around each change
+    // Subtree of node at position i spans [spanStart[i], i] in postfix
+    std::vector<int> spanStart(postOrder.size()), parentPosition(postOrder.size(), -1);
+    std::vector<int> positionStack;
+    for (int i = 0; i < (int)patchedExpression.size(); ++i)
+    {
+        spanStart[i] = i;
+        if (is_operator(patchedExpression[i]))
+        {
+            int position2 = positionStack.back();
+            positionStack.pop_back();
+            int position1 = positionStack.back();
+            positionStack.pop_back();
+            spanStart[i] = spanStart[position1];
+            parentPosition[position1] = parentPosition[position2] = i;
+        }
+        positionStack.push_back(i);
+    }
+    outWindowBegin = (int)patchedExpression.size();
+    outWindowEnd = 0;
+    for (int currNode : affectedNodes)
+    {
+        if (!nodeList[currNode].isAlive || nodePosition[currNode] == -1)
+        {
+            continue;
+        }
+        int position = nodePosition[currNode];
+        while (parentPosition[position] != -1 && (position - spanStart[position] + 2) / 2 < ECOWINDOWLEAVES)
+        {
+            position = parentPosition[position];
+        }
+        outWindowBegin = std::min(outWindowBegin, spanStart[position]);
+        outWindowEnd = std::max(outWindowEnd, position + 1);
+    }
+    if (outWindowBegin >= outWindowEnd)
+    {
+        // No change => whole expression
+        outWindowBegin = 0;
+        outWindowEnd = -1;
+    }
+    return true;
+}
+
+/*
+* Function to get the low temperature configuration for the ECO anneal
+* @param inConfig -> normal run configuration
+* @return configuration starting at ECOTEMPSCALE of the normal temperature
+* with ECORUNSCALE of the moves per temperature
+*/
+annealConfig_t eco_anneal_config(const annealConfig_t& inConfig)
+{
+    annealConfig_t ecoConfig = inConfig;
+    ecoConfig.initialTemperature = inConfig.initialTemperature * ECOTEMPSCALE;
+    ecoConfig.tempConstraint = inConfig.tempConstraint * ECOTEMPSCALE;
+    ecoConfig.runMultiplier = std::max(1, (int)(inConfig.runMultiplier * ECORUNSCALE));
+    return ecoConfig;
+}
@@ -0,0 +1,88 @@
+#ifndef __ECO_FLOORPLAN_H__
+#define __ECO_FLOORPLAN_H__
+
+#include <string>
+#include <vector>
+
+#include "PolishExpression.h"
+#include "Annealer.h"
+
+/*
+* ECO constraints
+*/
+// Minimum number of modules in the move window around each change
+#define ECOWINDOWLEAVES 16
+// Maximum insertion points tried per new module
+#define ECOINSERTCANDIDATES 512
+// ECO start temperature as a fraction of the normal start temperature
+#define ECOTEMPSCALE 0.01f
+// ECO moves per temperature as a fraction of the normal run multiplier
+#define ECORUNSCALE 0.1f
+
+/*
+* Type for one change in the module delta file
+*
+* Delta file format (one change per line):
+*   add <module_name> <area> <aspect_ratio> [...]
+*   update <module_name> <area> <aspect_ratio> [...]
+*   remove <module_name>
+*/
+typedef struct moduleDelta_t
+{
+    std::string action;
+    cirModule_t module;
+} moduleDelta_t;
+
+/*
+* Function to read a polish expression saved from the sa output
+* @param inputFile -> file holding the expression
+* @param outExpression -> expression tokens
+* @return bool if an expression was found
+*
+* NOTE: If the file holds a full sa log, the line after
+* "Best polish expression found:" is used, else the first line
+*/
+bool read_expression_file(const std::string& inputFile, std::vector<std::string>& outExpression);
+
+/*
+* Function to read the module delta file
+* @param inputFile -> file to read
+* @param outDelta -> changes in file order
+* @return bool if the file is valid
+*/
+bool read_delta_file(const std::string& inputFile, std::vector<moduleDelta_t>& outDelta);
+
+/*
+* Function to apply the module delta to the module list
+* @param moduleList -> modules to update
+* @param delta -> changes to apply
+* @return bool if all changes refer to valid modules
+*/
+bool apply_module_delta(std::vector<cirModule_t>& moduleList, const std::vector<moduleDelta_t>& delta);
+
+/*
+* Function to patch the previous expression for the changed modules
+* @param ioExpression -> expression holding the updated modules, set to the patched expression
+* @param previousExpression -> best expression of the previous run
+* @param delta -> changes applied to the modules
+* @param outWindowBegin -> start of the expression range around the changes
+* @param outWindowEnd -> end (exclusive) of the expression range around the changes
+* @return bool if the previous expression is valid
+*
+* Logic: Removed modules are cut out of the slicing tree (sibling takes the place
+* of the parent), new modules are paired with the node giving the least area,
+* the tree is normalized (skewed) again and the window is the union of the
+* subtrees of at least ECOWINDOWLEAVES modules around each change.
+*/
+bool patch_expression(PolishExpression& ioExpression, const std::vector<std::string>& previousExpression,
+    const std::vector<moduleDelta_t>& delta, int& outWindowBegin, int& outWindowEnd);
+
+/*
+* Function to get the low temperature configuration for the ECO anneal
+* @param inConfig -> normal run configuration
+* @return configuration starting at ECOTEMPSCALE of the normal temperature
+* with ECORUNSCALE of the moves per temperature
+*/
+annealConfig_t eco_anneal_config(const annealConfig_t& inConfig);
+
+#endif // !__ECO_FLOORPLAN_H__
@@ -0,0 +1,358 @@
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+
+#include "ExactSolver.h"
+
+/*
+* Operator tokens in the search expression (operands are module IDs >= 0)
+*/
+#define EXACT_H_TOKEN -1
+#define EXACT_V_TOKEN -2
+
+/*
+* Type for the entries of the search stack (one per built subtree)
+*/
+typedef struct exactEntry_t
+{
+    float width;
+    float height;
+    // Smallest module ID in the subtree
+    int minId;
+    // Root operator token, 0 for a module
+    int rootOp;
+} exactEntry_t;
+
+/*
+* Type for the best solution shared between the worker threads
+*/
+typedef struct exactShared_t
+{
+    std::atomic<float> bestCost;
+    std::vector<int> bestTokens;
+    std::mutex bestMutex;
+} exactShared_t;
+
+/*
+* Depth first search state of one worker
+*/
+class ExactSearch
+{
+private:
+    const ModuleStore& moduleStore;
+    exactShared_t& shared;
+    int moduleCount;
+    // Current postfix expression and stack of built subtrees
+    std::vector<int> tokens;
+    std::vector<exactEntry_t> entryStack;
+    // Modules used so far (bit per module ID)
+    unsigned int usedMask;
+    // Area of modules not yet pushed
+    float remainingArea;
+    // Prefix collection mode (collectDepth > 0)
+    int collectDepth;
+    std::vector<std::vector<int> >* collectedPrefixes;
+
+    /*
+    * Function to offer a complete expression as best solution
+    */
+    void offer_solution(float inCost);
+
+public:
+    long long nodesVisited;
+
+    ExactSearch(const ModuleStore& inStore, exactShared_t& inShared);
+
+    /*
+    * Function to reset to the empty expression
+    */
+    void reset();
+
+    /*
+    * Function to apply a token without keeping undo data (prefix replay)
+    * @param token -> module ID or operator token
+    */
+    void apply_token(int token);
+
+    /*
+    * Function to set the prefix collection mode
+    * @param inDepth -> prefix length to stop at (0 => full search)
+    * @param outPrefixes -> list to add prefixes to
+    */
+    void set_collect(int inDepth, std::vector<std::vector<int> >* outPrefixes);
+
+    /*
+    * Function to run the branch and bound from the current state
+    */
+    void dfs();
+};
+
+ExactSearch::ExactSearch(const ModuleStore& inStore, exactShared_t& inShared)
+    : moduleStore(inStore), shared(inShared)
+{
+    this->moduleCount = inStore.size();
+    this->tokens.reserve(2 * this->moduleCount);
+    this->entryStack.reserve(this->moduleCount);
+    this->collectDepth = 0;
+    this->collectedPrefixes = NULL;
+    this->nodesVisited = 0;
+    this->reset();
+}
+
+/*
+* Function to reset to the empty expression
+*/
+void ExactSearch::reset()
+{
+    this->tokens.clear();
+    this->entryStack.clear();
+    this->usedMask = 0;
+    this->remainingArea = 0;
+    for (int id = 0; id < this->moduleCount; ++id)
+    {
+        this->remainingArea += this->moduleStore.width(id) * this->moduleStore.height(id);
+    }
+}
+
+/*
+* Function to set the prefix collection mode
+* @param inDepth -> prefix length to stop at (0 => full search)
+* @param outPrefixes -> list to add prefixes to
+*/
+void ExactSearch::set_collect(int inDepth, std::vector<std::vector<int> >* outPrefixes)
+{
+    this->collectDepth = inDepth;
+    this->collectedPrefixes = outPrefixes;
+}
+
+/*
+* Function to apply a token without keeping undo data (prefix replay)
+* @param token -> module ID or operator token
+*/
+void ExactSearch::apply_token(int token)
+{
+    this->tokens.push_back(token);
+    if (token >= 0)
+    {
+        exactEntry_t leaf;
+        leaf.width = this->moduleStore.width(token);
+        leaf.height = this->moduleStore.height(token);
+        leaf.minId = token;
+        leaf.rootOp = 0;
+        this->entryStack.push_back(leaf);
+        this->usedMask |= (1u << token);
+        this->remainingArea -= leaf.width * leaf.height;
+        return;
+    }
+    exactEntry_t right = this->entryStack.back();
+    this->entryStack.pop_back();
+    exactEntry_t& left = this->entryStack.back();
+    if (token == EXACT_V_TOKEN)
+    {
+        left.width = left.width + right.width;
+        left.height = std::max(left.height, right.height);
+    }
+    else
+    {
+        left.width = std::max(left.width, right.width);
+        left.height = left.height + right.height;
+    }
+    left.rootOp = token;
+}
+
+/*
+* Function to offer a complete expression as best solution
+*/
+void ExactSearch::offer_solution(float inCost)
+{
+    std::lock_guard<std::mutex> bestLock(this->shared.bestMutex);
+    if (inCost < this->shared.bestCost.load())
+    {
+        this->shared.bestCost.store(inCost);
+        this->shared.bestTokens = this->tokens;
+    }
+}
+
+/*
+* Function to run the branch and bound from the current state
+*/
+void ExactSearch::dfs()
+{
+    ++this->nodesVisited;
+    int stackSize = (int)this->entryStack.size();
+    if ((int)this->tokens.size() == 2 * this->moduleCount - 1)
+    {
+        // Complete expression
+        float area = this->entryStack[0].width * this->entryStack[0].height;
+        if (area < this->shared.bestCost.load(std::memory_order_relaxed))
+        {
+            this->offer_solution(area);
+        }
+        return;
+    }
+
+    // Lower bound: stack boxes are disjoint in the final floorplan
+    float boxArea = this->remainingArea, maxWidth = 0, maxHeight = 0;
+    for (int i = 0; i < stackSize; ++i)
+    {
+        const exactEntry_t& currEntry = this->entryStack[i];
+        boxArea += currEntry.width * currEntry.height;
+        maxWidth = std::max(maxWidth, currEntry.width);
+        maxHeight = std::max(maxHeight, currEntry.height);
+    }
+    if (std::max(boxArea, maxWidth * maxHeight) >= this->shared.bestCost.load(std::memory_order_relaxed))
+    {
+        return;
+    }
+    if (this->collectDepth > 0 && (int)this->tokens.size() == this->collectDepth)
+    {
+        this->collectedPrefixes->push_back(this->tokens);
+        return;
+    }
+
+    // Close the top two subtrees (operators first to get bounds early)
+    if (stackSize >= 2)
+    {
+        exactEntry_t right = this->entryStack[stackSize - 1];
+        exactEntry_t left = this->entryStack[stackSize - 2];
+        for (int token = EXACT_H_TOKEN; token >= EXACT_V_TOKEN; --token)
+        {
+            // Skewed tree: right child cannot have the same operator
+            if (right.rootOp == token)
+            {
+                continue;
+            }
+            this->apply_token(token);
+            this->dfs();
+            // Undo
+            this->tokens.pop_back();
+            this->entryStack.back() = left;
+            this->entryStack.push_back(right);
+        }
+    }
+
+    // Push a module, ID must be above the min ID of the stack top
+    // (first module pushed is always ID 0)
+    int firstId = (stackSize == 0) ? 0 : this->entryStack[stackSize - 1].minId + 1;
+    int lastId = (stackSize == 0) ? 0 : this->moduleCount - 1;
+    float savedArea = this->remainingArea;
+    for (int id = firstId; id <= lastId; ++id)
+    {
+        if (this->usedMask & (1u << id))
+        {
+            continue;
+        }
+        this->apply_token(id);
+        this->dfs();
+        // Undo
+        this->tokens.pop_back();
+        this->entryStack.pop_back();
+        this->usedMask &= ~(1u << id);
+        this->remainingArea = savedArea;
+    }
+}
+
+/*
+* Function to check if the exact solver can be used for an expression
+* @param inExpression -> expression holding the modules
+* @return bool if all modules are hard (shape curves not supported)
+*/
+bool exact_solver_supported(PolishExpression& inExpression)
+{
+    const ModuleStore& moduleStore = inExpression.get_module_store();
+    return moduleStore.size() >= 2 && moduleStore.size() <= 32 && !moduleStore.has_flexible_modules();
+}
+
+/*
+* Function to find the minimum area slicing floorplan (branch and bound)
+* @param inExpression -> expression holding the modules, updated to the optimal expression
+* @param threadCount -> number of worker threads (0 => hardware concurrency)
+* @return result of the search
+*/
+exactResult_t solve_exact(PolishExpression& inExpression, int threadCount)
+{
+    exactResult_t result;
+    std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+    const ModuleStore& moduleStore = inExpression.get_module_store();
+    if (threadCount <= 0)
+    {
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    // Current expression is the starting upper bound
+    exactShared_t shared;
+    shared.bestCost.store(inExpression.compute_area());
+
+    // Split the first levels of the search into tasks
+    std::vector<std::vector<int> > taskPrefixes;
+    ExactSearch collectSearch(moduleStore, shared);
+    for (int depth = 1; depth < 2 * moduleStore.size() - 1; ++depth)
+    {
+        taskPrefixes.clear();
+        collectSearch.reset();
+        collectSearch.set_collect(depth, &taskPrefixes);
+        collectSearch.dfs();
+        if ((int)taskPrefixes.size() >= threadCount * EXACTTASKSPERTHREAD)
+        {
+            break;
+        }
+    }
+    result.nodesVisited = collectSearch.nodesVisited;
+
+    // Workers pick the next task until none left
+    std::atomic<int> nextTask(0);
+    std::atomic<long long> nodesVisited(0);
+    std::vector<std::thread> workerList;
+    for (int t = 0; t < threadCount; ++t)
+    {
+        workerList.push_back(std::thread([&]()
+        {
+            ExactSearch workerSearch(moduleStore, shared);
+            int taskIndex;
+            while ((taskIndex = nextTask.fetch_add(1)) < (int)taskPrefixes.size())
+            {
+                workerSearch.reset();
+                for (int token : taskPrefixes[taskIndex])
+                {
+                    workerSearch.apply_token(token);
+                }
+                workerSearch.dfs();
+            }
+            nodesVisited += workerSearch.nodesVisited;
+        }));
+    }
+    for (auto& worker : workerList)
+    {
+        worker.join();
+    }
+    result.nodesVisited += nodesVisited.load();
+
+    // Convert the best tokens back to the polish expression
+    if (!shared.bestTokens.empty())
+    {
+        std::vector<std::string> bestExpression;
+        for (int token : shared.bestTokens)
+        {
+            if (token == EXACT_H_TOKEN)
+            {
+                bestExpression.push_back(H_t);
+            }
+            else if (token == EXACT_V_TOKEN)
+            {
+                bestExpression.push_back(V_t);
+            }
+            else
+            {
+                bestExpression.push_back(moduleStore.name(token));
+            }
+        }
+        inExpression.update_expression(bestExpression);
+    }
+    result.bestExpression = inExpression.get_polish_expression();
+    result.bestCost = inExpression.compute_area();
+    result.runTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    return result;
+}
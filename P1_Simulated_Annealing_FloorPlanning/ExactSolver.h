@@ -0,0 +1,55 @@
+#ifndef __EXACT_SOLVER_H__
+#define __EXACT_SOLVER_H__
+
+#include <vector>
+#include <string>
+
+#include "PolishExpression.h"
+
+/*
+* Run constraints
+*/
+// Module count up to which the driver uses the exact solver
+#define EXACTTHRESHOLD 12
+// Number of prefix tasks generated per worker thread
+#define EXACTTASKSPERTHREAD 16
+
+/*
+* Type for the result of the exact solver
+*/
+typedef struct exactResult_t
+{
+    std::vector<std::string> bestExpression;
+    float bestCost = 0;
+    // Number of search nodes expanded
+    long long nodesVisited = 0;
+    // Wall time of the search in seconds
+    double runTime = 0;
+} exactResult_t;
+
+/*
+* Function to check if the exact solver can be used for an expression
+* @param inExpression -> expression holding the modules
+* @return bool if all modules are hard (shape curves not supported)
+*/
+bool exact_solver_supported(PolishExpression& inExpression);
+
+/*
+* Function to find the minimum area slicing floorplan (branch and bound)
+* @param inExpression -> expression holding the modules, updated to the optimal expression
+* @param threadCount -> number of worker threads (0 => hardware concurrency)
+* @return result of the search
+*
+* Logic: Depth first build of the postfix expression. Only one normalized
+* expression per floorplan up to child order is generated: operators never repeat
+* (skewed tree) and module IDs must increase from left child to right child
+* => stack entries hold increasing min IDs and an operand can only be pushed if
+* its ID is larger than the min ID of the stack top.
+* Lower bound: bounding box area of every stack entry + area of unused modules,
+* and max width * max height of the stack entries.
+* The first levels of the search are split into tasks run by the worker threads,
+* which share the best cost found.
+*/
+exactResult_t solve_exact(PolishExpression& inExpression, int threadCount = 0);
+
+#endif // !__EXACT_SOLVER_H__
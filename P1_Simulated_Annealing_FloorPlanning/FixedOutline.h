@@ -0,0 +1,56 @@
+#ifndef __FIXED_OUTLINE_H__
+#define __FIXED_OUTLINE_H__
+
+#include <algorithm>
+
+/*
+* Fixed outline constraints
+*/
+// Cost per unit of chip area outside the outline
+#define OUTLINEPENALTYWEIGHT 10.0f
+
+/*
+* Type for the fixed die outline of a block (width or height 0 => no outline)
+*/
+typedef struct fixedOutline_t
+{
+    float width = 0;
+    float height = 0;
+    float penaltyWeight = OUTLINEPENALTYWEIGHT;
+} fixedOutline_t;
+
+/*
+* Type for the chip bounding box found by an area evaluation
+*/
+typedef struct chipBox_t
+{
+    float width = 0;
+    float height = 0;
+} chipBox_t;
+
+/*
+* Function to check if an outline is set
+* @param inOutline -> outline to check
+* @return bool if width and height are set
+*/
+inline bool is_outline_active(const fixedOutline_t& inOutline)
+{
+    return inOutline.width > 0 && inOutline.height > 0;
+}
+
+/*
+* Function to compute the cost of a chip box under an outline
+* @param width -> chip width
+* @param height -> chip height
+* @param inOutline -> active outline
+* @return chip area + penaltyWeight * chip area outside the outline
+*
+* NOTE: Grows with width and height => a lower bound on the box gives a lower bound on the cost
+*/
+inline float outline_cost(float width, float height, const fixedOutline_t& inOutline)
+{
+    float insideArea = std::min(width, inOutline.width) * std::min(height, inOutline.height);
+    return width * height + inOutline.penaltyWeight * (width * height - insideArea);
+}
+
+#endif // !__FIXED_OUTLINE_H__
@@ -0,0 +1,318 @@
+
+#include <memory>
+#include <chrono>
+
+#include "Floorplanner.h"
+#include "Annealer.h"
+#include "SpeculativeAnnealer.h"
+#include "ExactSolver.h"
+#include "EcoFloorplan.h"
+#include "InitialSolution.h"
+#include "Netlist.h"
+#include "PerfProfiler.h"
+#include "MoveTrace.h"
+#include "IslandModel.h"
+#include "LargeNeighbourhood.h"
+#include "ParetoArchive.h"
+
+/*
+* Function to finish a successful run (shared exit of every solver and the replay)
+* @param ioExpression -> expression at the best floorplan
+* @param options -> run options
+* @param ioResult -> result with bestCost set, gets chipArea and isValid
+* @param logStream -> stream for the progress messages
+*/
+static void finish_result(PolishExpression& ioExpression, const runOptions_t& options, floorplanResult_t& ioResult,
+    std::ostream& logStream)
+{
+    ioResult.chipArea = ioResult.bestCost;
+    if (is_outline_active(options.outline))
+    {
+        // bestCost holds the outline penalty, report the bounding box next to it
+        float chipWidth, chipHeight;
+        ioExpression.compute_chip_size(chipWidth, chipHeight);
+        ioResult.chipArea = chipWidth * chipHeight;
+        bool isLegal = chipWidth <= options.outline.width && chipHeight <= options.outline.height;
+        logStream << "Outline " << options.outline.width << "x" << options.outline.height << ": chip "
+            << chipWidth << "x" << chipHeight << (isLegal ? " fits" : " exceeds the outline") << ", whitespace "
+            << 100 * (1 - ioExpression.get_module_store().total_area() / (chipWidth * chipHeight)) << "%\n";
+    }
+    ioResult.isValid = true;
+}
+
+/*
+* Function to run one floorplan from a module list
+* @param ioExpression -> empty expression, holds the modules and best expression after run
+* @param moduleList -> modules of the design (ECO delta is applied on a copy)
+* @param options -> run options
+* @param logStream -> stream for the progress messages
+* @return result of the run
+*
+* Flow: apply ECO delta, add modules, read netlist, build the initial expression
+* (or patch the previous one for ECO), then run the exact solver or the annealer
+*/
+floorplanResult_t run_floorplan(PolishExpression& ioExpression, std::vector<cirModule_t> moduleList,
+    const runOptions_t& options, std::ostream& logStream)
+{
+    floorplanResult_t result;
+    std::vector<moduleDelta_t> moduleDelta;
+    if (!options.ecoDeltaFile.empty() &&
+        (!read_delta_file(options.ecoDeltaFile, moduleDelta) || !apply_module_delta(moduleList, moduleDelta)))
+    {
+        return result;
+    }
+    for (auto& currModule : moduleList)
+    {
+        ioExpression.add_module(currModule.name, currModule);
+    }
+    int modulesCount = ioExpression.get_module_count();
+    if (modulesCount == 0)
+    {
+        logStream << "No modules in input\n";
+        return result;
+    }
+    // Every cost from here on includes the outline penalty
+    ioExpression.set_outline(options.outline);
+    // Full evaluations (start, export) of very large designs use the worker threads
+    ioExpression.set_eval_threads(options.threadCount);
+    bool hasOutline = is_outline_active(options.outline);
+
+    Netlist netlist;
+    if (!options.netlistFile.empty() && !netlist.read_netlist_file(options.netlistFile, ioExpression.get_module_store()))
+    {
+        return result;
+    }
+
+    if (!options.traceReplayFile.empty())
+    {
+        // Re-run the recorded moves (timing of the evaluation engine only)
+        replayResult_t replayResult = replay_move_trace(ioExpression, options.traceReplayFile, logStream);
+        if (!replayResult.isValid)
+        {
+            return result;
+        }
+        logStream << "Replayed " << replayResult.movesReplayed << " moves in " << replayResult.steps << " steps: "
+            << replayResult.runTime << "s, best cost " << replayResult.bestCost << " (recorded "
+            << replayResult.recordedBestCost << ((replayResult.bestCost == replayResult.recordedBestCost) ? ", match)\n" : ", MISMATCH)\n");
+        result.solver = "replay";
+        result.bestCost = replayResult.bestCost;
+        result.runTime = replayResult.runTime;
+        finish_result(ioExpression, options, result, logStream);
+        return result;
+    }
+
+    // Simulated Annealing
+    annealConfig_t config = options.config;
+    // Cost curve starts before the initial expression is built (ECO: patched)
+    std::chrono::steady_clock::time_point setupStart = std::chrono::steady_clock::now();
+    if (!options.ecoExpressionFile.empty())
+    {
+        // ECO: patch the previous best expression and anneal at low temperature around the changes
+        std::vector<std::string> previousExpression;
+        int windowBegin, windowEnd;
+        if (!read_expression_file(options.ecoExpressionFile, previousExpression) ||
+            !patch_expression(ioExpression, previousExpression, moduleDelta, windowBegin, windowEnd))
+        {
+            return result;
+        }
+        ioExpression.set_move_window(windowBegin, windowEnd);
+        config = eco_anneal_config(options.config);
+        result.initialCost = ioExpression.compute_area();
+        logStream << "ECO move window: " << windowBegin << " to " << windowEnd << "\n";
+        logStream << "Initial patched solution area: " << result.initialCost << "\n";
+    }
+    else
+    {
+        // Random start is the reference of the constructive ones
+        float randomCost = 0;
+        if (options.initMethod != "random")
+        {
+            create_initial_expression(ioExpression, "random", netlist);
+            randomCost = ioExpression.compute_area();
+        }
+        // Create initial polish expression
+        if (!create_initial_expression(ioExpression, options.initMethod, netlist))
+        {
+            return result;
+        }
+        result.initialCost = ioExpression.compute_area();
+        logStream << "Initial " << options.initMethod << " solution area: " << result.initialCost << "\n";
+        if (options.initMethod != "random")
+        {
+            if (result.initialCost < randomCost)
+            {
+                // Better start => skip the hottest part of the schedule
+                config.initialTemperature *= CONSTRUCTIVETEMPSCALE;
+            }
+            else
+            {
+                logStream << "Not better than the random start (" << randomCost << "), annealing from the full temperature\n";
+            }
+        }
+    }
+
+    result.setupTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - setupStart).count();
+
+    bool useExact = (options.solver == "exact") ||
+        (options.solver == "auto" && modulesCount <= EXACTTHRESHOLD && options.ecoExpressionFile.empty() &&
+        options.traceRecordFile.empty() && options.paretoFile.empty() && !hasOutline);
+    if (useExact && hasOutline)
+    {
+        // Exact solver bounds and minimizes the area only
+        logStream << "Exact solver does not support a fixed outline, using annealing\n";
+        useExact = false;
+    }
+    if (useExact && !exact_solver_supported(ioExpression))
+    {
+        logStream << "Exact solver needs 2 to 32 hard modules, using annealing\n";
+        useExact = false;
+    }
+    if ((useExact || options.islandCount > 1) && !options.traceRecordFile.empty())
+    {
+        logStream << "Move traces are only recorded by the single process annealer\n";
+    }
+    if ((useExact || options.islandCount > 1) && !options.paretoFile.empty())
+    {
+        logStream << "Pareto archive is only kept by the single process annealer\n";
+    }
+    if (useExact)
+    {
+        // Branch and bound over normalized polish expressions
+        exactResult_t exactResult = solve_exact(ioExpression, options.threadCount);
+        logStream << "Exact solver: " << exactResult.nodesVisited << " nodes in " << exactResult.runTime << "s\n";
+        result.solver = "exact";
+        result.bestCost = exactResult.bestCost;
+        result.runTime = exactResult.runTime;
+        result.costCurve.push_back({ result.setupTime, result.initialCost });
+        result.costCurve.push_back({ result.setupTime + result.runTime, result.bestCost });
+    }
+    else if (options.islandCount > 1)
+    {
+        // Forked islands (profiling and traces are per process => not supported)
+        islandResult_t islandResult = run_islands(ioExpression, config, options.islandCount, options.moveSelection, logStream);
+        if (!islandResult.isValid)
+        {
+            return result;
+        }
+        result.solver = "islands";
+        result.bestCost = islandResult.bestCost;
+        result.runTime = islandResult.runTime;
+        result.costCurve.push_back({ result.setupTime, result.initialCost });
+        result.costCurve.push_back({ result.setupTime + result.runTime, result.bestCost });
+    }
+    else
+    {
+        // SA loop
+        std::unique_ptr<PerfProfiler> profiler;
+        if (options.profileCounters)
+        {
+            profiler.reset(new PerfProfiler(PolishExpression::moveTypeCount, logStream));
+            if (!profiler->is_available())
+            {
+                logStream << "Hardware counters unavailable (" << profiler->get_unavailable_reason()
+                    << "), running without profiling\n";
+                profiler.reset();
+            }
+        }
+        std::unique_ptr<MoveTraceWriter> traceWriter;
+        if (!options.traceRecordFile.empty())
+        {
+            traceWriter.reset(new MoveTraceWriter(options.traceRecordFile));
+            if (!traceWriter->is_open())
+            {
+                return result;
+            }
+        }
+        std::unique_ptr<ParetoArchive> paretoArchive;
+        if (!options.paretoFile.empty())
+        {
+            paretoArchive.reset(new ParetoArchive(&netlist));
+        }
+        annealResult_t annealResult;
+        if (options.speculativeMoves > 1)
+        {
+            // Moves of one chain evaluated in parallel (no profiler, trace or archive, see parse_run_options)
+            if (options.moveSelection == "adaptive")
+            {
+                AdaptiveSpeculativeSlicingAnnealer annealer(ioExpression, config, options.speculativeMoves);
+                annealResult = annealer.run();
+            }
+            else
+            {
+                SpeculativeSlicingAnnealer annealer(ioExpression, config, options.speculativeMoves);
+                annealResult = annealer.run();
+            }
+        }
+        else if (options.moveSelection == "adaptive")
+        {
+            AdaptiveSlicingAnnealer annealer(ioExpression, config);
+            annealer.set_profiler(profiler.get());
+            annealer.set_trace_writer(traceWriter.get());
+            annealer.set_pareto_archive(paretoArchive.get());
+            annealResult = annealer.run();
+        }
+        else
+        {
+            SlicingAnnealer annealer(ioExpression, config);
+            annealer.set_profiler(profiler.get());
+            annealer.set_trace_writer(traceWriter.get());
+            annealer.set_pareto_archive(paretoArchive.get());
+            annealResult = annealer.run();
+        }
+        if (paretoArchive && paretoArchive->write_archive_file(options.paretoFile))
+        {
+            logStream << "Pareto archive: " << paretoArchive->size() << " floorplans (" << paretoArchive->get_insert_count()
+                << " inserted of " << paretoArchive->get_offer_count() << " accepted states) written to "
+                << options.paretoFile << "\n";
+        }
+        if (traceWriter)
+        {
+            logStream << "Recorded " << traceWriter->get_record_count() << " trace records to " << options.traceRecordFile << "\n";
+        }
+        if (annealResult.targetMet)
+        {
+            logStream << "Whitespace target met after " << annealResult.attempts << " temperature steps\n";
+        }
+        print_move_stats(annealResult.moveStats, logStream);
+        if (profiler)
+        {
+            profiler->print_report();
+        }
+        result.solver = "anneal";
+        result.bestCost = annealResult.bestCost;
+        result.runTime = annealResult.runTime;
+        result.costCurve.swap(annealResult.costCurve);
+        // Annealer samples are relative to its own start
+        for (auto& currSample : result.costCurve)
+        {
+            currSample.time += result.setupTime;
+        }
+    }
+    // Moves on the whole expression for any later use
+    ioExpression.set_move_window(0, -1);
+
+    if (options.lnsPolish && !useExact)
+    {
+        // Polishing stage: exhaustive re-optimization of small subtrees
+        if (hasOutline)
+        {
+            logStream << "Subtree polishing does not support a fixed outline, skipped\n";
+        }
+        else if (!lns_supported(ioExpression))
+        {
+            logStream << "Subtree polishing needs at least " << LNSMINLEAVES << " hard modules, skipped\n";
+        }
+        else
+        {
+            lnsResult_t lnsResult = run_lns(ioExpression, options.threadCount, config.seed);
+            logStream << "Subtree polishing: " << lnsResult.initialCost << " -> " << lnsResult.bestCost << " in "
+                << lnsResult.rounds << " rounds (" << lnsResult.windowsImproved << "/" << lnsResult.windowsTried
+                << " subtrees improved), " << lnsResult.runTime << "s\n";
+            result.bestCost = lnsResult.bestCost;
+            result.runTime += lnsResult.runTime;
+            result.costCurve.push_back({ result.setupTime + result.runTime, result.bestCost });
+        }
+    }
+    finish_result(ioExpression, options, result, logStream);
+    return result;
+}
@@ -0,0 +1,47 @@
+#ifndef __FLOORPLANNER_H__
+#define __FLOORPLANNER_H__
+
+#include <vector>
+#include <string>
+#include <ostream>
+
+#include "PolishExpression.h"
+#include "RunOptions.h"
+
+/*
+* Type for the outcome of a floorplan run
+*/
+typedef struct floorplanResult_t
+{
+    // False if an input (delta, netlist, expression) was invalid
+    bool isValid = false;
+    float initialCost = 0;
+    // Cost minimized (area + outline penalty with a fixed outline)
+    float bestCost = 0;
+    // Bounding box area of the best floorplan (bestCost without an outline)
+    float chipArea = 0;
+    // Solver used: exact or anneal
+    std::string solver;
+    // Wall time of the ECO patching / initial expression construction in seconds
+    double setupTime = 0;
+    // Wall time of the solver in seconds
+    double runTime = 0;
+    // Best cost over the time since the setup start (anneal: every temperature step, others: start and end)
+    std::vector<costSample_t> costCurve;
+} floorplanResult_t;
+
+/*
+* Function to run one floorplan from a module list
+* @param ioExpression -> empty expression, holds the modules and best expression after run
+* @param moduleList -> modules of the design (ECO delta is applied on a copy)
+* @param options -> run options
+* @param logStream -> stream for the progress messages
+* @return result of the run
+*
+* Flow: apply ECO delta, add modules, read netlist, build the initial expression
+* (or patch the previous one for ECO), then run the exact solver or the annealer
+*/
+floorplanResult_t run_floorplan(PolishExpression& ioExpression, std::vector<cirModule_t> moduleList,
+    const runOptions_t& options, std::ostream& logStream);
+
+#endif // !__FLOORPLANNER_H__
@@ -0,0 +1,342 @@
+
+#include <iostream>
+#include <algorithm>
+#include <cmath>
+
+#include "InitialSolution.h"
+
+/*
+* Data shared by the recursive bipartition
+*/
+typedef struct bipartitionData_t
+{
+    const ModuleStore* moduleStore;
+    const Netlist* netlist;
+    // Nets per module (CSR layout), empty if no min-cut
+    std::vector<int> moduleNetOffsets;
+    std::vector<int> moduleNets;
+    // Side of each module in the current bipartition (-1 => not in range)
+    std::vector<int> moduleSide;
+    // Pins of each net per side in the current bipartition
+    std::vector<int> netSideCount[2];
+    std::vector<std::string>* outExpression;
+} bipartitionData_t;
+
+/*
+* Function to compute the gain of moving a module to the other side
+* @param data -> bipartition data
+* @param id -> module ID
+* @return number of nets that stop being cut minus nets that start being cut
+*/
+static int compute_move_gain(const bipartitionData_t& data, int id)
+{
+    int fromSide = data.moduleSide[id], toSide = 1 - fromSide;
+    int gain = 0;
+    for (int i = data.moduleNetOffsets[id]; i < data.moduleNetOffsets[id + 1]; ++i)
+    {
+        int net = data.moduleNets[i];
+        if (data.netSideCount[fromSide][net] == 1 && data.netSideCount[toSide][net] > 0)
+        {
+            ++gain;
+        }
+        else if (data.netSideCount[toSide][net] == 0 && data.netSideCount[fromSide][net] > 1)
+        {
+            --gain;
+        }
+    }
+    return gain;
+}
+
+/*
+* Function to update the net counts of a module
+* @param data -> bipartition data
+* @param id -> module ID
+* @param delta -> +1 to add the module to its side, -1 to remove
+*/
+static void update_net_counts(bipartitionData_t& data, int id, int delta)
+{
+    for (int i = data.moduleNetOffsets[id]; i < data.moduleNetOffsets[id + 1]; ++i)
+    {
+        data.netSideCount[data.moduleSide[id]][data.moduleNets[i]] += delta;
+    }
+}
+
+/*
+* Function to refine a bipartition to cut less nets
+* @param data -> bipartition data (moduleSide set for the range)
+* @param idList -> modules in range
+* @param sideArea -> area per side, updated
+*
+* Logic: Fiduccia-Mattheyses like pass without locking: modules are visited in
+* order of gain and moved if the gain is still positive and the balance holds.
+*/
+static void refine_min_cut(bipartitionData_t& data, const std::vector<int>& idList, float sideArea[2])
+{
+    float totalArea = sideArea[0] + sideArea[1];
+    for (int id : idList)
+    {
+        update_net_counts(data, id, 1);
+    }
+    std::vector<std::pair<int, int> > gainList(idList.size());
+    for (int pass = 0; pass < MINCUTPASSES; ++pass)
+    {
+        for (size_t i = 0; i < idList.size(); ++i)
+        {
+            gainList[i] = std::make_pair(-compute_move_gain(data, idList[i]), idList[i]);
+        }
+        std::sort(gainList.begin(), gainList.end());
+        bool anyMove = false;
+        for (auto& currGain : gainList)
+        {
+            int id = currGain.second;
+            int fromSide = data.moduleSide[id];
+            float area = data.moduleStore->area(id);
+            if (currGain.first >= 0 || compute_move_gain(data, id) <= 0 ||
+                sideArea[1 - fromSide] + area > (1 - MINCUTBALANCE) * totalArea ||
+                sideArea[fromSide] - area < MINCUTBALANCE * totalArea)
+            {
+                continue;
+            }
+            update_net_counts(data, id, -1);
+            data.moduleSide[id] = 1 - fromSide;
+            update_net_counts(data, id, 1);
+            sideArea[fromSide] -= area;
+            sideArea[1 - fromSide] += area;
+            anyMove = true;
+        }
+        if (!anyMove)
+        {
+            break;
+        }
+    }
+    // Reset the counts for the next bipartition
+    for (int id : idList)
+    {
+        update_net_counts(data, id, -1);
+    }
+}
+
+/*
+* Function to build the expression of a module range by recursive bipartition
+* @param data -> bipartition data
+* @param idList -> modules sorted by decreasing area
+* @param regionWidth -> width of the region targeted for the modules
+* @param regionHeight -> height of the region targeted for the modules
+* @return bounding box (width, height) and root operator (empty for module) of the range
+*
+* Logic: The region (square at the top) is cut across its longer side into two
+* regions sized by the area of each half. The halves are swapped if needed so that
+* the right child never has the same operator as its parent (normalized expression).
+* A side with less than BIPARTITIONMINSHARE of the modules (skewed areas) is replaced
+* by a split by count, keeping the recursion depth O(log n).
+*/
+static cirModule_t build_bipartition(bipartitionData_t& data, const std::vector<int>& idList,
+    float regionWidth, float regionHeight)
+{
+    cirModule_t roomBox;
+    if (idList.size() == 1)
+    {
+        data.outExpression->push_back(data.moduleStore->name(idList[0]));
+        roomBox.width = data.moduleStore->width(idList[0]);
+        roomBox.height = data.moduleStore->height(idList[0]);
+        roomBox.name = "";
+        return roomBox;
+    }
+    // Largest modules first, each to the lighter side
+    float sideArea[2] = { 0, 0 };
+    for (int id : idList)
+    {
+        int side = (sideArea[0] <= sideArea[1]) ? 0 : 1;
+        data.moduleSide[id] = side;
+        sideArea[side] += data.moduleStore->area(id);
+    }
+    if (!data.moduleNets.empty())
+    {
+        refine_min_cut(data, idList, sideArea);
+    }
+    // Stable split keeps the area order in both halves
+    std::vector<int> sideList[2];
+    for (int id : idList)
+    {
+        sideList[data.moduleSide[id]].push_back(id);
+    }
+    if (std::min(sideList[0].size(), sideList[1].size()) < BIPARTITIONMINSHARE * idList.size())
+    {
+        // Skewed areas peel off one module per level (O(n) depth) => alternate in area order
+        sideList[0].clear();
+        sideList[1].clear();
+        sideArea[0] = sideArea[1] = 0;
+        for (size_t i = 0; i < idList.size(); ++i)
+        {
+            sideList[i % 2].push_back(idList[i]);
+            sideArea[i % 2] += data.moduleStore->area(idList[i]);
+        }
+    }
+    for (int id : idList)
+    {
+        data.moduleSide[id] = -1;
+    }
+    bool isVertical = regionWidth >= regionHeight;
+    float firstShare = sideArea[0] / (sideArea[0] + sideArea[1]);
+    size_t firstStart = data.outExpression->size();
+    cirModule_t box1 = isVertical ?
+        build_bipartition(data, sideList[0], regionWidth * firstShare, regionHeight) :
+        build_bipartition(data, sideList[0], regionWidth, regionHeight * firstShare);
+    size_t secondStart = data.outExpression->size();
+    cirModule_t box2 = isVertical ?
+        build_bipartition(data, sideList[1], regionWidth * (1 - firstShare), regionHeight) :
+        build_bipartition(data, sideList[1], regionWidth, regionHeight * (1 - firstShare));
+
+    // Both halves cut the same way as this region => other cut to stay normalized
+    if (box1.name == box2.name && box1.name == (isVertical ? V_t : H_t))
+    {
+        isVertical = !isVertical;
+    }
+    roomBox.name = isVertical ? V_t : H_t;
+    roomBox.width = isVertical ? box1.width + box2.width : std::max(box1.width, box2.width);
+    roomBox.height = isVertical ? std::max(box1.height, box2.height) : box1.height + box2.height;
+    if (box2.name == roomBox.name)
+    {
+        // Swap the halves (same area) to keep the right child normalized
+        std::rotate(data.outExpression->begin() + firstStart, data.outExpression->begin() + secondStart,
+            data.outExpression->end());
+    }
+    data.outExpression->push_back(roomBox.name);
+    return roomBox;
+}
+
+/*
+* Function to build the shelf packing expression
+* @param moduleStore -> modules to pack
+* @param outExpression -> expression to fill
+*
+* Logic: Modules sorted by decreasing height fill a shelf left to right (V chain)
+* until the shelf width is reached, shelves are stacked bottom to top (H chain)
+*/
+static void build_shelf(const ModuleStore& moduleStore, std::vector<std::string>& outExpression)
+{
+    std::vector<int> idList(moduleStore.size());
+    float totalArea = 0, maxWidth = 0;
+    for (int id = 0; id < moduleStore.size(); ++id)
+    {
+        idList[id] = id;
+        totalArea += moduleStore.width(id) * moduleStore.height(id);
+        maxWidth = std::max(maxWidth, moduleStore.width(id));
+    }
+    std::stable_sort(idList.begin(), idList.end(), [&](int id1, int id2)
+    {
+        return moduleStore.height(id1) > moduleStore.height(id2);
+    });
+    float shelfLimit = std::max(maxWidth, SHELFWIDTHSCALE * std::sqrt(totalArea));
+    float shelfWidth = 0;
+    int shelfIndex = 0, shelfModules = 0;
+    for (int id : idList)
+    {
+        if (shelfModules > 0 && shelfWidth + moduleStore.width(id) > shelfLimit)
+        {
+            // Close the shelf and stack it on the shelves below
+            if (shelfIndex > 0)
+            {
+                outExpression.push_back(H_t);
+            }
+            ++shelfIndex;
+            shelfWidth = 0;
+            shelfModules = 0;
+        }
+        outExpression.push_back(moduleStore.name(id));
+        shelfWidth += moduleStore.width(id);
+        if (++shelfModules > 1)
+        {
+            outExpression.push_back(V_t);
+        }
+    }
+    if (shelfIndex > 0)
+    {
+        outExpression.push_back(H_t);
+    }
+}
+
+/*
+* Function to create the initial polish expression
+* @param ioExpression -> expression holding the modules, set to the initial expression
+* @param method -> random, balanced, shelf or mincut
+* @param netlist -> nets between the modules (needed for mincut)
+* @return bool if the method is valid
+*/
+bool create_initial_expression(PolishExpression& ioExpression, const std::string& method, const Netlist& netlist)
+{
+    if (method == "random")
+    {
+        ioExpression.create_random_expression();
+        return true;
+    }
+    const ModuleStore& moduleStore = ioExpression.get_module_store();
+    std::vector<std::string> initialExpression;
+    initialExpression.reserve(2 * moduleStore.size());
+    if (method == "shelf")
+    {
+        build_shelf(moduleStore, initialExpression);
+    }
+    else if (method == "balanced" || method == "mincut")
+    {
+        if (method == "mincut" && netlist.empty())
+        {
+            std::cerr << "Initial solution mincut needs a netlist\n";
+            return false;
+        }
+        bipartitionData_t data;
+        data.moduleStore = &moduleStore;
+        data.netlist = &netlist;
+        data.outExpression = &initialExpression;
+        data.moduleSide.assign(moduleStore.size(), -1);
+        if (method == "mincut")
+        {
+            // Nets per module
+            data.moduleNetOffsets.assign(moduleStore.size() + 1, 0);
+            for (int net = 0; net < netlist.size(); ++net)
+            {
+                for (int pin = netlist.pin_begin(net); pin < netlist.pin_end(net); ++pin)
+                {
+                    ++data.moduleNetOffsets[netlist.pin_module(pin) + 1];
+                }
+            }
+            for (int id = 0; id < moduleStore.size(); ++id)
+            {
+                data.moduleNetOffsets[id + 1] += data.moduleNetOffsets[id];
+            }
+            data.moduleNets.resize(data.moduleNetOffsets.back());
+            std::vector<int> fillIndex(data.moduleNetOffsets.begin(), data.moduleNetOffsets.end() - 1);
+            for (int net = 0; net < netlist.size(); ++net)
+            {
+                for (int pin = netlist.pin_begin(net); pin < netlist.pin_end(net); ++pin)
+                {
+                    data.moduleNets[fillIndex[netlist.pin_module(pin)]++] = net;
+                }
+            }
+            data.netSideCount[0].assign(netlist.size(), 0);
+            data.netSideCount[1].assign(netlist.size(), 0);
+        }
+        std::vector<int> idList(moduleStore.size());
+        for (int id = 0; id < moduleStore.size(); ++id)
+        {
+            idList[id] = id;
+        }
+        std::stable_sort(idList.begin(), idList.end(), [&](int id1, int id2)
+        {
+            return moduleStore.area(id1) > moduleStore.area(id2);
+        });
+        float totalArea = 0;
+        for (int id : idList)
+        {
+            totalArea += moduleStore.area(id);
+        }
+        build_bipartition(data, idList, std::sqrt(totalArea), std::sqrt(totalArea));
+    }
+    else
+    {
+        std::cerr << "Invalid initial solution " << method << "\n";
+        return false;
+    }
+    ioExpression.update_expression(initialExpression);
+    return true;
+}
@@ -0,0 +1,38 @@
+#ifndef __INITIAL_SOLUTION_H__
+#define __INITIAL_SOLUTION_H__
+
+#include <string>
+
+#include "PolishExpression.h"
+#include "Netlist.h"
+
+/*
+* Initial solution constraints
+*/
+// Start temperature scaling when a constructive solution beats the random one
+#define CONSTRUCTIVETEMPSCALE 0.1f
+// Shelf width as a multiple of sqrt(total module area)
+#define SHELFWIDTHSCALE 1.0f
+// Allowed area imbalance of a min-cut bipartition (fraction of the total area per side)
+#define MINCUTBALANCE 0.4f
+// Number of gain passes per min-cut bipartition
+#define MINCUTPASSES 2
+// Smallest side of a bipartition (fraction of its modules) before splitting by count instead of area
+#define BIPARTITIONMINSHARE 0.25f
+
+/*
+* Function to create the initial polish expression
+* @param ioExpression -> expression holding the modules, set to the initial expression
+* @param method -> random, balanced, shelf or mincut
+* @param netlist -> nets between the modules (needed for mincut)
+* @return bool if the method is valid
+*
+* random: modules in ID order chained with V
+* balanced: area-sorted recursive bipartition into equal area halves, cuts alternate V/H
+* shelf: modules sorted by height packed left to right into shelves stacked bottom to top
+* mincut: balanced bipartition refined to cut the least nets at each level
+* All constructive methods are O(n log n) and give normalized expressions.
+*/
+bool create_initial_expression(PolishExpression& ioExpression, const std::string& method, const Netlist& netlist);
+
+#endif // !__INITIAL_SOLUTION_H__
@@ -0,0 +1,381 @@
+
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <new>
+#include <random>
+
+#include <fcntl.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "IslandModel.h"
+
+/*
+* Operator tokens on the board (operands are module IDs >= 0)
+*/
+#define ISLAND_H_TOKEN -1
+#define ISLAND_V_TOKEN -2
+
+/*
+* Type for the header of one island slot (followed by the expression tokens)
+*/
+typedef struct islandSlot_t
+{
+    // Seqlock version: odd while the island writes the slot, 0 => never written
+    std::atomic<uint32_t> version;
+    float cost;
+    // Migrations that replaced this island's state
+    int32_t adoptions;
+} islandSlot_t;
+
+/*
+* View of the board in shared memory
+*/
+class IslandBoard
+{
+private:
+    char* boardMemory;
+    size_t slotStride;
+    int islandCount;
+    int tokenCount;
+
+    islandSlot_t* slot(int island) const { return reinterpret_cast<islandSlot_t*>(this->boardMemory + island * this->slotStride); }
+    int32_t* tokens(int island) const { return reinterpret_cast<int32_t*>(this->boardMemory + island * this->slotStride + sizeof(islandSlot_t)); }
+
+public:
+    IslandBoard(int inIslandCount, int inTokenCount)
+    {
+        this->islandCount = inIslandCount;
+        this->tokenCount = inTokenCount;
+        // Slots on separate cache lines
+        this->slotStride = (sizeof(islandSlot_t) + inTokenCount * sizeof(int32_t) + 63) / 64 * 64;
+        this->boardMemory = NULL;
+    }
+
+    ~IslandBoard()
+    {
+        if (this->boardMemory)
+        {
+            munmap(this->boardMemory, this->slotStride * this->islandCount);
+        }
+    }
+
+    /*
+    * Function to create the shared memory (before the fork)
+    * @return bool if the memory could be mapped
+    */
+    bool create()
+    {
+        size_t boardSize = this->slotStride * this->islandCount;
+        std::string shmName = "/sa_islands_" + std::to_string(getpid());
+        int shmFd = shm_open(shmName.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+        if (shmFd < 0)
+        {
+            std::cerr << "Unable to create shared memory: " << std::strerror(errno) << "\n";
+            return false;
+        }
+        // Name is not needed once mapped (children inherit the mapping)
+        shm_unlink(shmName.c_str());
+        void* mapped = MAP_FAILED;
+        if (ftruncate(shmFd, boardSize) == 0)
+        {
+            mapped = mmap(NULL, boardSize, PROT_READ | PROT_WRITE, MAP_SHARED, shmFd, 0);
+        }
+        close(shmFd);
+        if (mapped == MAP_FAILED)
+        {
+            std::cerr << "Unable to map shared memory: " << std::strerror(errno) << "\n";
+            return false;
+        }
+        this->boardMemory = static_cast<char*>(mapped);
+        for (int island = 0; island < this->islandCount; ++island)
+        {
+            islandSlot_t* currSlot = new (this->slot(island)) islandSlot_t;
+            currSlot->version.store(0);
+            currSlot->cost = 0;
+            currSlot->adoptions = 0;
+        }
+        return true;
+    }
+
+    /*
+    * Function to publish the best expression of an island (only writer of its slot)
+    */
+    void publish(int island, const std::vector<int32_t>& inTokens, float inCost, int inAdoptions)
+    {
+        islandSlot_t* currSlot = this->slot(island);
+        uint32_t version = currSlot->version.load(std::memory_order_relaxed);
+        currSlot->version.store(version + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        currSlot->cost = inCost;
+        currSlot->adoptions = inAdoptions;
+        std::memcpy(this->tokens(island), inTokens.data(), this->tokenCount * sizeof(int32_t));
+        currSlot->version.store(version + 2, std::memory_order_release);
+    }
+
+    /*
+    * Function to read a consistent copy of a slot
+    * @return bool if the slot holds a solution and was read without a concurrent write
+    */
+    bool read(int island, std::vector<int32_t>& outTokens, float& outCost, int& outAdoptions) const
+    {
+        islandSlot_t* currSlot = this->slot(island);
+        outTokens.resize(this->tokenCount);
+        for (int retry = 0; retry < ISLANDREADRETRIES; ++retry)
+        {
+            uint32_t version = currSlot->version.load(std::memory_order_acquire);
+            if (version == 0)
+            {
+                return false;
+            }
+            if (version & 1)
+            {
+                continue;
+            }
+            outCost = currSlot->cost;
+            outAdoptions = currSlot->adoptions;
+            std::memcpy(outTokens.data(), this->tokens(island), this->tokenCount * sizeof(int32_t));
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (currSlot->version.load(std::memory_order_relaxed) == version)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+};
+
+/*
+* Function to convert an expression to board tokens
+*/
+static void to_tokens(const ModuleStore& moduleStore, const std::vector<std::string>& inExpression, std::vector<int32_t>& outTokens)
+{
+    outTokens.resize(inExpression.size());
+    for (size_t i = 0; i < inExpression.size(); ++i)
+    {
+        const std::string& element = inExpression[i];
+        outTokens[i] = is_operator(element) ?
+            (is_vertical_partition(element) ? ISLAND_V_TOKEN : ISLAND_H_TOKEN) : moduleStore.find_id(element);
+    }
+}
+
+/*
+* Function to convert board tokens to an expression
+*/
+static void to_expression(const ModuleStore& moduleStore, const std::vector<int32_t>& inTokens, std::vector<std::string>& outExpression)
+{
+    outExpression.resize(inTokens.size());
+    for (size_t i = 0; i < inTokens.size(); ++i)
+    {
+        int32_t token = inTokens[i];
+        outExpression[i] = (token == ISLAND_H_TOKEN) ? H_t : (token == ISLAND_V_TOKEN) ? V_t : moduleStore.name(token);
+    }
+}
+
+/*
+* Function to pin the calling process to the CPUs of a NUMA node
+* @param island -> island index (node = island % node count)
+*
+* NOTE: No NUMA information => not pinned
+*/
+static void pin_to_numa_node(int island)
+{
+    int nodeCount = 0;
+    while (access(("/sys/devices/system/node/node" + std::to_string(nodeCount)).c_str(), F_OK) == 0)
+    {
+        ++nodeCount;
+    }
+    if (nodeCount == 0)
+    {
+        return;
+    }
+    // cpulist format: 0-3,8-11
+    std::ifstream cpuListFile("/sys/devices/system/node/node" + std::to_string(island % nodeCount) + "/cpulist");
+    std::string cpuList;
+    if (!std::getline(cpuListFile, cpuList))
+    {
+        return;
+    }
+    cpu_set_t cpuSet;
+    CPU_ZERO(&cpuSet);
+    size_t position = 0;
+    while (position < cpuList.size())
+    {
+        size_t rangeEnd = cpuList.find(',', position);
+        if (rangeEnd == std::string::npos)
+        {
+            rangeEnd = cpuList.size();
+        }
+        std::string range = cpuList.substr(position, rangeEnd - position);
+        size_t dash = range.find('-');
+        if (!range.empty() && range[0] >= '0' && range[0] <= '9')
+        {
+            int first = std::stoi(range.substr(0, dash));
+            int last = (dash == std::string::npos) ? first : std::stoi(range.substr(dash + 1));
+            for (int cpu = first; cpu <= last && cpu < CPU_SETSIZE; ++cpu)
+            {
+                CPU_SET(cpu, &cpuSet);
+            }
+        }
+        position = rangeEnd + 1;
+    }
+    if (CPU_COUNT(&cpuSet) > 0)
+    {
+        sched_setaffinity(0, sizeof(cpuSet), &cpuSet);
+    }
+}
+
+/*
+* Function to run one island (in the child process)
+*/
+template <typename AnnealerType>
+static void run_island(PolishExpression& ioExpression, annealConfig_t config, IslandBoard& board, int island, int islandCount)
+{
+    const ModuleStore& moduleStore = ioExpression.get_module_store();
+    config.verbose = false;
+    if (config.seed != 0)
+    {
+        config.seed += island * ISLANDSEEDSTRIDE;
+    }
+    else
+    {
+        // Moves RNG was seeded before the fork => new seed per island
+        std::random_device rd;
+        config.seed = rd();
+    }
+    int adoptions = 0;
+    std::vector<int32_t> tokenList, otherTokens;
+    std::vector<std::string> otherExpression;
+
+    AnnealerType annealer(ioExpression, config);
+    annealer.set_step_hook([&](PolishExpression& state, float& currCost,
+        const PolishExpression::state_t& bestState, float bestCost, int step)
+    {
+        if (step % ISLANDMIGRATIONSTEPS != 0)
+        {
+            return;
+        }
+        to_tokens(moduleStore, bestState, tokenList);
+        board.publish(island, tokenList, bestCost, adoptions);
+        // Adopt the best elite of the other islands if it beats our best
+        int bestIsland = -1;
+        float eliteCost = bestCost;
+        for (int other = 0; other < islandCount; ++other)
+        {
+            float otherCost;
+            int otherAdoptions;
+            if (other != island && board.read(other, otherTokens, otherCost, otherAdoptions) && otherCost < eliteCost)
+            {
+                eliteCost = otherCost;
+                bestIsland = other;
+                tokenList.swap(otherTokens);
+            }
+        }
+        if (bestIsland != -1)
+        {
+            to_expression(moduleStore, tokenList, otherExpression);
+            state.restore_state(otherExpression);
+            currCost = eliteCost;
+            ++adoptions;
+        }
+    });
+    annealResult_t annealResult = annealer.run();
+    to_tokens(moduleStore, annealResult.bestExpression, tokenList);
+    board.publish(island, tokenList, annealResult.bestCost, adoptions);
+}
+
+/*
+* Function to anneal with several forked islands sharing their best solutions
+* @param ioExpression -> expression holding the modules and start expression, set to the best result
+* @param config -> annealing configuration (seed is offset per island)
+* @param islandCount -> number of worker processes
+* @param moveSelection -> schedule or adaptive
+* @param logStream -> stream for the island summary
+* @return result of the run
+*/
+islandResult_t run_islands(PolishExpression& ioExpression, const annealConfig_t& config, int islandCount,
+    const std::string& moveSelection, std::ostream& logStream)
+{
+    islandResult_t result;
+    std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+    const ModuleStore& moduleStore = ioExpression.get_module_store();
+    int tokenCount = (int)ioExpression.get_polish_expression().size();
+    IslandBoard board(islandCount, tokenCount);
+    if (!board.create())
+    {
+        return result;
+    }
+
+    // Children must not flush output buffered before the fork
+    std::cout.flush();
+    logStream.flush();
+    std::vector<pid_t> childList;
+    for (int island = 0; island < islandCount; ++island)
+    {
+        pid_t pid = fork();
+        if (pid < 0)
+        {
+            std::cerr << "Unable to fork island " << island << ": " << std::strerror(errno) << "\n";
+            break;
+        }
+        if (pid == 0)
+        {
+            pin_to_numa_node(island);
+            if (moveSelection == "adaptive")
+            {
+                run_island<AdaptiveSlicingAnnealer>(ioExpression, config, board, island, islandCount);
+            }
+            else
+            {
+                run_island<SlicingAnnealer>(ioExpression, config, board, island, islandCount);
+            }
+            // Skip the destructors and exit handlers of the parent state
+            _exit(0);
+        }
+        childList.push_back(pid);
+    }
+    for (pid_t pid : childList)
+    {
+        int status;
+        waitpid(pid, &status, 0);
+    }
+
+    // Best of the final boards
+    std::vector<int32_t> tokenList, bestTokens;
+    result.bestCost = -1;
+    for (int island = 0; island < islandCount; ++island)
+    {
+        float islandCost;
+        int adoptions;
+        if (!board.read(island, tokenList, islandCost, adoptions))
+        {
+            result.islandCosts.push_back(-1);
+            continue;
+        }
+        result.islandCosts.push_back(islandCost);
+        result.adoptions += adoptions;
+        logStream << "Island " << island << ": best " << islandCost << ", adopted " << adoptions << " elites\n";
+        if (result.bestCost < 0 || islandCost < result.bestCost)
+        {
+            result.bestCost = islandCost;
+            bestTokens = tokenList;
+        }
+    }
+    if (bestTokens.empty())
+    {
+        std::cerr << "No island finished\n";
+        return result;
+    }
+    std::vector<std::string> bestExpression;
+    to_expression(moduleStore, bestTokens, bestExpression);
+    ioExpression.update_expression(bestExpression);
+    result.bestCost = ioExpression.compute_area();
+    result.runTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    result.isValid = true;
+    return result;
+}
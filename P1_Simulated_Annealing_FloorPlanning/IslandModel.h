@@ -0,0 +1,58 @@
+#ifndef __ISLAND_MODEL_H__
+#define __ISLAND_MODEL_H__
+
+#include <vector>
+#include <string>
+#include <ostream>
+
+#include "PolishExpression.h"
+#include "Annealer.h"
+
+/*
+* Island model constraints
+*/
+// Temperature steps between migrations
+#define ISLANDMIGRATIONSTEPS 4
+// Read attempts on a slot being written before skipping it for this migration
+#define ISLANDREADRETRIES 64
+// Seed offset between islands (seeded runs)
+#define ISLANDSEEDSTRIDE 7919
+
+/*
+* Type for the result of an island run
+*/
+typedef struct islandResult_t
+{
+    bool isValid = false;
+    float bestCost = 0;
+    // Final best cost per island (-1 if the island failed)
+    std::vector<float> islandCosts;
+    // Migrations that replaced an island's state
+    long long adoptions = 0;
+    // Wall time in seconds
+    double runTime = 0;
+} islandResult_t;
+
+/*
+* Function to anneal with several forked islands sharing their best solutions
+* @param ioExpression -> expression holding the modules and start expression, set to the best result
+* @param config -> annealing configuration (seed is offset per island)
+* @param islandCount -> number of worker processes
+* @param moveSelection -> schedule or adaptive
+* @param logStream -> stream for the island summary
+* @return result of the run
+*
+* Logic: The best-solution board lives in POSIX shared memory mapped before the
+* fork, one slot per island. Each island only writes its own slot (seqlock:
+* odd version while writing), so readers never block and retry or skip a slot
+* being written. Every ISLANDMIGRATIONSTEPS temperature steps an island
+* publishes its best expression and adopts the best one on the board if it is
+* better than its own. Each island is pinned to the CPUs of one NUMA node
+* (round robin over the nodes in /sys/devices/system/node).
+*
+* NOTE: Uses fork => only from a single threaded process (not in server jobs)
+*/
+islandResult_t run_islands(PolishExpression& ioExpression, const annealConfig_t& config, int islandCount,
+    const std::string& moveSelection, std::ostream& logStream);
+
+#endif // !__ISLAND_MODEL_H__
@@ -0,0 +1,420 @@
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <random>
+#include <thread>
+
+#include "LargeNeighbourhood.h"
+
+/*
+* Type for one node of the slicing tree (same index as the expression element)
+*/
+typedef struct lnsNode_t
+{
+    float width;
+    float height;
+    int child1;
+    int child2;
+    int parent;
+    int leafCount;
+    // Module ID for a leaf, -1 for an operator
+    int moduleId;
+    bool isVertical;
+} lnsNode_t;
+
+/*
+* Type for one point of a subset frontier
+*/
+typedef struct lnsPoint_t
+{
+    float width;
+    float height;
+    // Left/bottom subset and the points used (leftMask == 0 => leaf)
+    int leftMask;
+    int leftPoint;
+    int rightPoint;
+    bool isVertical;
+} lnsPoint_t;
+
+/*
+* Type for the best replacement found for one subtree
+*/
+typedef struct lnsCandidate_t
+{
+    int root;
+    float bestCost;
+    std::vector<std::string> tokens;
+    // Replaced range of the expression [begin, end]
+    int begin;
+    int end;
+} lnsCandidate_t;
+
+/*
+* Function to build the slicing tree of an expression
+* @return root index
+*/
+static int build_tree(const std::vector<std::string>& inExpression, const ModuleStore& moduleStore, std::vector<lnsNode_t>& outNodes)
+{
+    outNodes.resize(inExpression.size());
+    std::vector<int> nodeStack;
+    for (int index = 0; index < (int)inExpression.size(); ++index)
+    {
+        lnsNode_t& currNode = outNodes[index];
+        currNode.parent = -1;
+        if (is_operator(inExpression[index]))
+        {
+            currNode.child2 = nodeStack.back();
+            nodeStack.pop_back();
+            currNode.child1 = nodeStack.back();
+            nodeStack.pop_back();
+            const lnsNode_t& node1 = outNodes[currNode.child1];
+            const lnsNode_t& node2 = outNodes[currNode.child2];
+            currNode.isVertical = is_vertical_partition(inExpression[index]);
+            currNode.width = currNode.isVertical ? node1.width + node2.width : std::max(node1.width, node2.width);
+            currNode.height = currNode.isVertical ? std::max(node1.height, node2.height) : node1.height + node2.height;
+            currNode.leafCount = node1.leafCount + node2.leafCount;
+            currNode.moduleId = -1;
+            outNodes[currNode.child1].parent = index;
+            outNodes[currNode.child2].parent = index;
+        }
+        else
+        {
+            currNode.moduleId = moduleStore.find_id(inExpression[index]);
+            currNode.width = moduleStore.width(currNode.moduleId);
+            currNode.height = moduleStore.height(currNode.moduleId);
+            currNode.child1 = currNode.child2 = -1;
+            currNode.leafCount = 1;
+            currNode.isVertical = false;
+        }
+        nodeStack.push_back(index);
+    }
+    return nodeStack.back();
+}
+
+/*
+* Function to keep the non-dominated points (smaller width and height)
+*/
+static void prune_frontier(std::vector<lnsPoint_t>& ioPoints)
+{
+    std::sort(ioPoints.begin(), ioPoints.end(), [](const lnsPoint_t& point1, const lnsPoint_t& point2)
+    {
+        return (point1.width < point2.width) || (point1.width == point2.width && point1.height < point2.height);
+    });
+    size_t keep = 0;
+    for (size_t i = 0; i < ioPoints.size(); ++i)
+    {
+        if (keep == 0 || ioPoints[i].height < ioPoints[keep - 1].height)
+        {
+            ioPoints[keep++] = ioPoints[i];
+        }
+    }
+    ioPoints.resize(keep);
+}
+
+/*
+* Function to collect the operands of a chain of the same operator (left to right)
+*/
+static void collect_chain(const std::vector<std::vector<lnsPoint_t> >& frontier, int mask, int point,
+    bool isVertical, std::vector<std::pair<int, int> >& outChain)
+{
+    const lnsPoint_t& currPoint = frontier[mask][point];
+    if (currPoint.leftMask == 0 || currPoint.isVertical != isVertical)
+    {
+        outChain.push_back(std::make_pair(mask, point));
+        return;
+    }
+    collect_chain(frontier, currPoint.leftMask, currPoint.leftPoint, isVertical, outChain);
+    collect_chain(frontier, mask ^ currPoint.leftMask, currPoint.rightPoint, isVertical, outChain);
+}
+
+/*
+* Function to emit the normalized postfix expression of a frontier point
+* @param chainOnly -> emit the root chain as x1 op x2 op ... (right child of the same operator)
+*/
+static void emit_point(const std::vector<std::vector<lnsPoint_t> >& frontier, const std::vector<int>& leafIds,
+    const ModuleStore& moduleStore, int mask, int point, bool chainOnly, std::vector<std::string>& outTokens)
+{
+    const lnsPoint_t& currPoint = frontier[mask][point];
+    if (currPoint.leftMask == 0)
+    {
+        // Single module subset
+        int bit = 0;
+        while (!(mask & (1 << bit)))
+        {
+            ++bit;
+        }
+        outTokens.push_back(moduleStore.name(leafIds[bit]));
+        return;
+    }
+    std::vector<std::pair<int, int> > chain;
+    collect_chain(frontier, mask, point, currPoint.isVertical, chain);
+    std::string op = currPoint.isVertical ? V_t : H_t;
+    for (size_t i = 0; i < chain.size(); ++i)
+    {
+        emit_point(frontier, leafIds, moduleStore, chain[i].first, chain[i].second, false, outTokens);
+        if (chainOnly || i > 0)
+        {
+            outTokens.push_back(op);
+        }
+    }
+}
+
+/*
+* Function to find the best replacement of one subtree
+* @return bool if a replacement improves the area
+*/
+static bool optimize_window(const std::vector<lnsNode_t>& nodeList, int root,
+    const ModuleStore& moduleStore, float currCost, lnsCandidate_t& outCandidate)
+{
+    const lnsNode_t& rootNode = nodeList[root];
+    int leafCount = rootNode.leafCount;
+    int begin = root - (2 * leafCount - 1) + 1;
+    std::vector<int> leafIds;
+    for (int index = begin; index <= root; ++index)
+    {
+        if (nodeList[index].moduleId != -1)
+        {
+            leafIds.push_back(nodeList[index].moduleId);
+        }
+    }
+
+    // Frontier per module subset
+    int fullMask = (1 << leafCount) - 1;
+    std::vector<std::vector<lnsPoint_t> > frontier(fullMask + 1);
+    for (int bit = 0; bit < leafCount; ++bit)
+    {
+        lnsPoint_t leaf = { moduleStore.width(leafIds[bit]), moduleStore.height(leafIds[bit]), 0, 0, 0, false };
+        frontier[1 << bit].push_back(leaf);
+    }
+    for (int mask = 1; mask <= fullMask; ++mask)
+    {
+        if ((mask & (mask - 1)) == 0)
+        {
+            continue;
+        }
+        std::vector<lnsPoint_t>& currFrontier = frontier[mask];
+        int lowBit = mask & -mask;
+        // Unordered split: left subset holds the lowest module (V and H are symmetric in size)
+        for (int leftMask = (mask - 1) & mask; leftMask > 0; leftMask = (leftMask - 1) & mask)
+        {
+            if (!(leftMask & lowBit))
+            {
+                continue;
+            }
+            const std::vector<lnsPoint_t>& leftFrontier = frontier[leftMask];
+            const std::vector<lnsPoint_t>& rightFrontier = frontier[mask ^ leftMask];
+            for (int i = 0; i < (int)leftFrontier.size(); ++i)
+            {
+                for (int j = 0; j < (int)rightFrontier.size(); ++j)
+                {
+                    const lnsPoint_t& left = leftFrontier[i];
+                    const lnsPoint_t& right = rightFrontier[j];
+                    lnsPoint_t vertical = { left.width + right.width, std::max(left.height, right.height), leftMask, i, j, true };
+                    lnsPoint_t horizontal = { std::max(left.width, right.width), left.height + right.height, leftMask, i, j, false };
+                    currFrontier.push_back(vertical);
+                    currFrontier.push_back(horizontal);
+                }
+            }
+        }
+        prune_frontier(currFrontier);
+    }
+
+    // Score each point by the chip box on the path to the root
+    int bestPoint = -1;
+    float bestCost = currCost;
+    const std::vector<lnsPoint_t>& rootFrontier = frontier[fullMask];
+    for (int point = 0; point < (int)rootFrontier.size(); ++point)
+    {
+        float width = rootFrontier[point].width, height = rootFrontier[point].height;
+        int child = root;
+        for (int parent = rootNode.parent; parent != -1; child = parent, parent = nodeList[parent].parent)
+        {
+            const lnsNode_t& parentNode = nodeList[parent];
+            const lnsNode_t& sibling = nodeList[(parentNode.child1 == child) ? parentNode.child2 : parentNode.child1];
+            if (parentNode.isVertical)
+            {
+                width += sibling.width;
+                height = std::max(height, sibling.height);
+            }
+            else
+            {
+                width = std::max(width, sibling.width);
+                height += sibling.height;
+            }
+        }
+        if (width * height < bestCost)
+        {
+            bestCost = width * height;
+            bestPoint = point;
+        }
+    }
+    if (bestPoint == -1)
+    {
+        return false;
+    }
+
+    // Right child of the same operator => join the parent chain to stay normalized
+    const lnsPoint_t& chosen = rootFrontier[bestPoint];
+    int parent = rootNode.parent;
+    bool joinParent = parent != -1 && nodeList[parent].child2 == root && chosen.leftMask != 0 &&
+        nodeList[parent].isVertical == chosen.isVertical;
+    outCandidate.root = root;
+    outCandidate.bestCost = bestCost;
+    outCandidate.begin = begin;
+    outCandidate.end = joinParent ? parent : root;
+    outCandidate.tokens.clear();
+    emit_point(frontier, leafIds, moduleStore, fullMask, bestPoint, joinParent, outCandidate.tokens);
+    return (int)outCandidate.tokens.size() == outCandidate.end - outCandidate.begin + 1;
+}
+
+/*
+* Function to check if the large neighbourhood search can be used
+* @param inExpression -> expression holding the modules
+* @return bool if all modules are hard and there are at least LNSMINLEAVES
+*/
+bool lns_supported(PolishExpression& inExpression)
+{
+    const ModuleStore& moduleStore = inExpression.get_module_store();
+    return moduleStore.size() >= LNSMINLEAVES && !moduleStore.has_flexible_modules();
+}
+
+/*
+* Function to polish an expression by re-optimizing subtrees
+* @param ioExpression -> expression to improve in place
+* @param threadCount -> worker threads (0 => hardware concurrency)
+* @param seed -> seed for the window selection (0 => random device)
+* @return result of the search
+*/
+lnsResult_t run_lns(PolishExpression& ioExpression, int threadCount, unsigned int seed)
+{
+    lnsResult_t result;
+    std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+    const ModuleStore& moduleStore = ioExpression.get_module_store();
+    if (threadCount <= 0)
+    {
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+    std::default_random_engine randGenerator;
+    if (seed != 0)
+    {
+        randGenerator.seed(seed);
+    }
+    else
+    {
+        std::random_device rd;
+        randGenerator.seed(rd());
+    }
+
+    std::vector<std::string> currExpression = ioExpression.get_polish_expression();
+    float currCost = ioExpression.compute_area();
+    result.initialCost = currCost;
+    int stallRounds = 0;
+    std::vector<lnsNode_t> nodeList;
+    while (result.rounds < LNSMAXROUNDS && stallRounds < LNSSTALLROUNDS)
+    {
+        ++result.rounds;
+        int treeRoot = build_tree(currExpression, moduleStore, nodeList);
+
+        // Random disjoint subtrees (postfix ranges do not overlap)
+        std::vector<int> windowRoots;
+        for (int index = 0; index < (int)nodeList.size(); ++index)
+        {
+            if (nodeList[index].leafCount >= LNSMINLEAVES && nodeList[index].leafCount <= LNSMAXLEAVES)
+            {
+                windowRoots.push_back(index);
+            }
+        }
+        if (windowRoots.empty())
+        {
+            // Whole design is smaller than a window
+            windowRoots.push_back(treeRoot);
+        }
+        std::shuffle(windowRoots.begin(), windowRoots.end(), randGenerator);
+        std::vector<bool> isCovered(nodeList.size(), false);
+        std::vector<int> selectedRoots;
+        for (int root : windowRoots)
+        {
+            int begin = root - (2 * nodeList[root].leafCount - 1) + 1;
+            // A covered node inside the range => overlapping window
+            bool isFree = !isCovered[begin] && !isCovered[root];
+            for (int parent = nodeList[root].parent; isFree && parent != -1; parent = nodeList[parent].parent)
+            {
+                isFree = !isCovered[parent];
+            }
+            for (int index = begin; isFree && index <= root; ++index)
+            {
+                isFree = !isCovered[index];
+            }
+            if (!isFree)
+            {
+                continue;
+            }
+            for (int index = begin; index <= root; ++index)
+            {
+                isCovered[index] = true;
+            }
+            selectedRoots.push_back(root);
+        }
+
+        // Windows in parallel, all against the round start tree
+        std::vector<lnsCandidate_t> candidateList(selectedRoots.size());
+        std::vector<char> isImproved(selectedRoots.size(), 0);
+        std::atomic<int> nextWindow(0);
+        std::vector<std::thread> workerList;
+        int workerCount = std::min(threadCount, (int)selectedRoots.size());
+        for (int t = 0; t < workerCount; ++t)
+        {
+            workerList.push_back(std::thread([&]()
+            {
+                int window;
+                while ((window = nextWindow.fetch_add(1)) < (int)selectedRoots.size())
+                {
+                    isImproved[window] = optimize_window(nodeList, selectedRoots[window],
+                        moduleStore, currCost, candidateList[window]) ? 1 : 0;
+                }
+            }));
+        }
+        for (auto& worker : workerList)
+        {
+            worker.join();
+        }
+        result.windowsTried += selectedRoots.size();
+
+        // Splice the improving windows back, best first, keep if the full area improves
+        std::vector<int> order;
+        for (int window = 0; window < (int)selectedRoots.size(); ++window)
+        {
+            if (isImproved[window])
+            {
+                order.push_back(window);
+            }
+        }
+        std::sort(order.begin(), order.end(), [&](int window1, int window2)
+        {
+            return candidateList[window1].bestCost < candidateList[window2].bestCost;
+        });
+        bool roundImproved = false;
+        for (int window : order)
+        {
+            const lnsCandidate_t& candidate = candidateList[window];
+            std::vector<std::string> nextExpression = currExpression;
+            std::copy(candidate.tokens.begin(), candidate.tokens.end(), nextExpression.begin() + candidate.begin);
+            ioExpression.update_expression(nextExpression);
+            float nextCost = ioExpression.compute_area();
+            if (nextCost < currCost)
+            {
+                currExpression.swap(nextExpression);
+                currCost = nextCost;
+                ++result.windowsImproved;
+                roundImproved = true;
+            }
+        }
+        stallRounds = roundImproved ? 0 : stallRounds + 1;
+    }
+
+    ioExpression.update_expression(currExpression);
+    result.bestCost = ioExpression.compute_area();
+    result.runTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    return result;
+}
@@ -0,0 +1,56 @@
+#ifndef __LARGE_NEIGHBOURHOOD_H__
+#define __LARGE_NEIGHBOURHOOD_H__
+
+#include "PolishExpression.h"
+
+/*
+* Large neighbourhood search constraints
+*/
+// Leaves of a re-optimized subtree
+#define LNSMINLEAVES 6
+#define LNSMAXLEAVES 10
+// Stop after this many rounds without improvement
+#define LNSSTALLROUNDS 5
+// Upper limit on the rounds
+#define LNSMAXROUNDS 200
+
+/*
+* Type for the result of the large neighbourhood search
+*/
+typedef struct lnsResult_t
+{
+    float initialCost = 0;
+    float bestCost = 0;
+    int rounds = 0;
+    // Subtrees re-optimized and subtrees spliced back
+    long long windowsTried = 0;
+    long long windowsImproved = 0;
+    // Wall time in seconds
+    double runTime = 0;
+} lnsResult_t;
+
+/*
+* Function to check if the large neighbourhood search can be used
+* @param inExpression -> expression holding the modules
+* @return bool if all modules are hard and there are at least LNSMINLEAVES
+*/
+bool lns_supported(PolishExpression& inExpression);
+
+/*
+* Function to polish an expression by re-optimizing subtrees
+* @param ioExpression -> expression to improve in place
+* @param threadCount -> worker threads (0 => hardware concurrency)
+* @param seed -> seed for the window selection (0 => random device)
+* @return result of the search
+*
+* Logic: Each round picks a random set of disjoint subtrees with LNSMINLEAVES to
+* LNSMAXLEAVES leaves (rest of the expression fixed), one per task on the workers.
+* For a subtree, the exhaustive set of non-dominated (width, height) slicings of
+* its modules is built by dynamic programming over module subsets; the chip area
+* only grows with the subtree box, so the best replacement is one of these points,
+* each scored by updating the boxes on the path to the root. Improving subtrees are
+* spliced back (normalized) and kept if the full area still improves.
+*/
+lnsResult_t run_lns(PolishExpression& ioExpression, int threadCount, unsigned int seed);
+
+#endif // !__LARGE_NEIGHBOURHOOD_H__
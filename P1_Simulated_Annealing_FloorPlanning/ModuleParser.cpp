@@ -0,0 +1,165 @@
+
+#include <fstream>
+#include <iostream>
+#include <cmath>
+#include <stdexcept>
+
+#include "ModuleParser.h"
+#include "HelperFuncs.h"
+
+/*
+* Function to parse the module fields of one input line
+* @param fields -> line split on spaces
+* @param firstField -> index of the module name in fields
+* @param outModule -> module to fill
+* @return bool if the fields are valid
+*
+* Format: <module_name> <area> <aspect_ratio> [<min_aspect_ratio> <max_aspect_ratio>] [<rotatable>]
+*/
+bool parse_module_fields(const std::vector<std::string>& fields, size_t firstField, cirModule_t& outModule)
+{
+    size_t fieldCount = (fields.size() > firstField) ? fields.size() - firstField : 0;
+    if (fieldCount < 3 || fieldCount > 6)
+    {
+        std::cerr << "Incorrect format for input file";
+        return false;
+    }
+    // Area = h*w, Aspect ratio = w/h
+    outModule.name = fields[firstField];
+    try
+    {
+        outModule.area = std::stof(fields[firstField + 1]);
+        outModule.aspectRatio = std::stof(fields[firstField + 2]);
+        // Optional shape freedom
+        outModule.minAspectRatio = outModule.maxAspectRatio = outModule.aspectRatio;
+        outModule.isRotatable = false;
+        if (fieldCount >= 5)
+        {
+            outModule.minAspectRatio = std::stof(fields[firstField + 3]);
+            outModule.maxAspectRatio = std::stof(fields[firstField + 4]);
+        }
+        if (fieldCount == 4 || fieldCount == 6)
+        {
+            outModule.isRotatable = std::stoi(fields.back()) != 0;
+        }
+    }
+    catch (const std::invalid_argument&)
+    {
+        std::cerr << "Invalid number for module " << outModule.name << "\n";
+        return false;
+    }
+    catch (const std::out_of_range&)
+    {
+        std::cerr << "Number out of range for module " << outModule.name << "\n";
+        return false;
+    }
+    // Negated => NaN is rejected too
+    if (!(outModule.area > 0) || !(outModule.aspectRatio > 0))
+    {
+        std::cerr << "Area and aspect ratio must be positive for module " << outModule.name << "\n";
+        return false;
+    }
+    outModule.height = std::sqrt(outModule.area / outModule.aspectRatio);
+    outModule.width = std::sqrt(outModule.area * outModule.aspectRatio);
+    // Nominal shape must be one of the allowed ones
+    if (outModule.minAspectRatio <= 0 || outModule.minAspectRatio > outModule.maxAspectRatio ||
+        outModule.aspectRatio < outModule.minAspectRatio || outModule.aspectRatio > outModule.maxAspectRatio)
+    {
+        std::cerr << "Incorrect aspect ratio bounds for module " << outModule.name << "\n";
+        return false;
+    }
+    return true;
+}
+
+/*
+* Function to read and clean the lines of a text file
+* @param inputFile -> file to read
+* @param outLines -> non-empty lines split on spaces
+* @return bool if the file could be read
+*/
+bool read_split_lines(const std::string& inputFile, std::vector<std::vector<std::string> >& outLines)
+{
+    std::ifstream FH(inputFile);
+    if (!FH.is_open())
+    {
+        std::cerr << "Unable to open the input file " << inputFile << "\n";
+        return false;
+    }
+    std::string currentLine;
+    while (std::getline(FH, currentLine))
+    {
+        // Remove extra whitespaces
+        remove_newline(currentLine);
+        if (!currentLine.empty() && currentLine[currentLine.length() - 1] == '\r')
+        {
+            currentLine.erase(currentLine.length() - 1);
+        }
+        remove_tabs(currentLine);
+        remove_multiple_spaces(currentLine);
+        if (!currentLine.empty() && currentLine[0] == ' ')
+        {
+            currentLine.erase(0, 1);
+        }
+        if (!currentLine.empty() && currentLine[currentLine.length() - 1] == ' ')
+        {
+            currentLine.erase(currentLine.length() - 1);
+        }
+        if (currentLine.empty())
+        {
+            continue;
+        }
+        // Split the line based on spaces
+        outLines.push_back(split_str(currentLine));
+    }
+    FH.close();
+    return true;
+}
+
+/*
+* Function to read the module input file
+* @param inputFile -> file to read (text or binary module image)
+* @param outModules -> modules in file order
+* @return bool if the file is valid
+*/
+bool read_module_file(const std::string& inputFile, std::vector<cirModule_t>& outModules)
+{
+    if (ModuleStore::is_image_file(inputFile))
+    {
+        // Module list of an image (callers that need to edit the modules)
+        ModuleStore imageStore;
+        if (!imageStore.load_image(inputFile))
+        {
+            return false;
+        }
+        outModules.resize(imageStore.size());
+        for (int id = 0; id < imageStore.size(); ++id)
+        {
+            cirModule_t& currModule = outModules[id];
+            currModule.name = imageStore.name(id);
+            currModule.area = imageStore.area(id);
+            currModule.aspectRatio = imageStore.aspect_ratio(id);
+            currModule.width = imageStore.width(id);
+            currModule.height = imageStore.height(id);
+            currModule.minAspectRatio = imageStore.min_aspect_ratio(id);
+            currModule.maxAspectRatio = imageStore.max_aspect_ratio(id);
+            currModule.isRotatable = imageStore.is_rotatable(id);
+        }
+        return true;
+    }
+    std::vector<std::vector<std::string> > lineList;
+    if (!read_split_lines(inputFile, lineList))
+    {
+        return false;
+    }
+    outModules.reserve(lineList.size());
+    for (auto& currentLineVec : lineList)
+    {
+        cirModule_t currModule;
+        if (!parse_module_fields(currentLineVec, 0, currModule))
+        {
+            return false;
+        }
+        outModules.push_back(currModule);
+    }
+    return true;
+}
@@ -0,0 +1,36 @@
+#ifndef __MODULE_PARSER_H__
+#define __MODULE_PARSER_H__
+
+#include <string>
+#include <vector>
+
+#include "PolishExpression.h"
+
+/*
+* Function to parse the module fields of one input line
+* @param fields -> line split on spaces
+* @param firstField -> index of the module name in fields
+* @param outModule -> module to fill
+* @return bool if the fields are valid
+*
+* Format: <module_name> <area> <aspect_ratio> [<min_aspect_ratio> <max_aspect_ratio>] [<rotatable>]
+*/
+bool parse_module_fields(const std::vector<std::string>& fields, size_t firstField, cirModule_t& outModule);
+
+/*
+* Function to read and clean the lines of a text file
+* @param inputFile -> file to read
+* @param outLines -> non-empty lines split on spaces
+* @return bool if the file could be read
+*/
+bool read_split_lines(const std::string& inputFile, std::vector<std::vector<std::string> >& outLines);
+
+/*
+* Function to read the module input file
+* @param inputFile -> file to read (text or binary module image)
+* @param outModules -> modules in file order
+* @return bool if the file is valid
+*/
+bool read_module_file(const std::string& inputFile, std::vector<cirModule_t>& outModules);
+
+#endif // !__MODULE_PARSER_H__
@@ -0,0 +1,432 @@
+
+#include <cstring>
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "ModuleStore.h"
+
+/*
+* Base constructor
+*/
+ModuleStore::ModuleStore()
+{
+    this->flexibleCount = 0;
+    this->totalArea = 0;
+    this->hashSlots.assign(16, -1);
+}
+
+/*
+* Function to hash a name (FNV-1a)
+* @param inName -> name characters
+* @param inLength -> number of characters
+* @return hash value
+*/
+uint32_t ModuleStore::hash_name(const char* inName, size_t inLength)
+{
+    uint32_t hashValue = 2166136261u;
+    for (size_t i = 0; i < inLength; ++i)
+    {
+        hashValue ^= (unsigned char)inName[i];
+        hashValue *= 16777619u;
+    }
+    return hashValue;
+}
+
+/*
+* Function to find the hash slot for a name
+* @param inName -> name characters
+* @param inLength -> number of characters
+* @return slot index (either holding the name or the empty slot to use)
+*
+* Logic: Linear probing, table size is always power of 2
+*/
+size_t ModuleStore::find_slot(const char* inName, size_t inLength) const
+{
+    size_t mask = this->hashSlots.size() - 1;
+    size_t slot = hash_name(inName, inLength) & mask;
+    while (this->hashSlots[slot] != -1)
+    {
+        const char* storedName = this->name(this->hashSlots[slot]);
+        if (std::strncmp(storedName, inName, inLength) == 0 && storedName[inLength] == '\0')
+        {
+            return slot;
+        }
+        slot = (slot + 1) & mask;
+    }
+    return slot;
+}
+
+/*
+* Function to grow and rebuild the hash table
+*/
+void ModuleStore::rehash()
+{
+    this->hashSlots.assign(this->hashSlots.size() * 2, -1);
+    for (int id = 0; id < this->size(); ++id)
+    {
+        const char* currName = this->name(id);
+        this->hashSlots[this->find_slot(currName, std::strlen(currName))] = id;
+    }
+}
+
+/*
+* Function to reserve space for modules
+* @param size -> number of modules expected
+* @param nameBytes -> expected total bytes of names (0 to skip)
+*/
+void ModuleStore::reserve(int size, size_t nameBytes)
+{
+    this->widthVec.reserve(size);
+    this->heightVec.reserve(size);
+    this->areaVec.reserve(size);
+    this->aspectRatioVec.reserve(size);
+    this->placementXVec.reserve(size);
+    this->placementYVec.reserve(size);
+    this->minAspectRatioVec.reserve(size);
+    this->maxAspectRatioVec.reserve(size);
+    this->rotatableVec.reserve(size);
+    this->nameOffsetVec.reserve(size);
+    if (nameBytes > 0)
+    {
+        this->namePool.reserve(nameBytes);
+    }
+    // Keep load factor below 0.5
+    while (this->hashSlots.size() < 2 * (size_t)size)
+    {
+        this->rehash();
+    }
+}
+
+/*
+* Function to add module to the store
+* @param inName -> name of module
+* @param inArea -> area of module
+* @param inAspectRatio -> aspect ratio (w/h) of module
+* @param inWidth -> width of module
+* @param inHeight -> height of module
+* @return dense ID of module
+*
+* NOTE: Adding an existing name overwrites its data and keeps the ID
+*/
+int ModuleStore::add_module(const std::string& inName, float inArea, float inAspectRatio, float inWidth, float inHeight)
+{
+    size_t slot = this->find_slot(inName.c_str(), inName.length());
+    int id = this->hashSlots[slot];
+    if (id == -1)
+    {
+        // New module => intern the name and append the data
+        id = this->size();
+        this->nameOffsetVec.push_back((uint32_t)this->namePool.size());
+        this->namePool.insert(this->namePool.end(), inName.begin(), inName.end());
+        this->namePool.push_back('\0');
+        this->widthVec.push_back(0);
+        this->heightVec.push_back(0);
+        this->areaVec.push_back(0);
+        this->aspectRatioVec.push_back(0);
+        this->placementXVec.push_back(0);
+        this->placementYVec.push_back(0);
+        this->minAspectRatioVec.push_back(inAspectRatio);
+        this->maxAspectRatioVec.push_back(inAspectRatio);
+        this->rotatableVec.push_back(0);
+        this->hashSlots[slot] = id;
+        // Keep load factor below 0.5
+        if (2 * (size_t)this->size() > this->hashSlots.size())
+        {
+            this->rehash();
+        }
+    }
+    this->widthVec[id] = inWidth;
+    this->heightVec[id] = inHeight;
+    this->totalArea += inArea - this->areaVec[id];
+    this->areaVec[id] = inArea;
+    this->aspectRatioVec[id] = inAspectRatio;
+    return id;
+}
+
+/*
+* Function to find the ID of a module
+* @param inName -> name of module
+* @return dense ID, -1 if not present
+*/
+int ModuleStore::find_id(const std::string& inName) const
+{
+    return this->hashSlots[this->find_slot(inName.c_str(), inName.length())];
+}
+
+/*
+* Function to update the shape bounds of a module
+* @param id -> module ID
+* @param inMinAspectRatio -> minimum aspect ratio (w/h)
+* @param inMaxAspectRatio -> maximum aspect ratio (w/h)
+* @param inRotatable -> if module can be rotated by 90 degrees
+*/
+void ModuleStore::set_shape_bounds(int id, float inMinAspectRatio, float inMaxAspectRatio, bool inRotatable)
+{
+    if (this->is_flexible(id))
+    {
+        --this->flexibleCount;
+    }
+    this->minAspectRatioVec[id] = inMinAspectRatio;
+    this->maxAspectRatioVec[id] = inMaxAspectRatio;
+    this->rotatableVec[id] = inRotatable ? 1 : 0;
+    if (this->is_flexible(id))
+    {
+        ++this->flexibleCount;
+    }
+}
+
+/*
+* Function to update module dimensions by ID
+*/
+void ModuleStore::set_dimensions(int id, float inWidth, float inHeight)
+{
+    this->widthVec[id] = inWidth;
+    this->heightVec[id] = inHeight;
+}
+
+/*
+* Function to update module placement by ID
+*/
+void ModuleStore::set_placement(int id, float inX, float inY)
+{
+    this->placementXVec[id] = inX;
+    this->placementYVec[id] = inY;
+}
+
+/*
+* Function to clear the placement of all modules
+*/
+void ModuleStore::clear_placement()
+{
+    std::fill(this->placementXVec.begin(), this->placementXVec.end(), 0.0f);
+    std::fill(this->placementYVec.begin(), this->placementYVec.end(), 0.0f);
+}
+
+/*
+* Function to round a section size up to 8 bytes
+* @param inBytes -> section size
+* @return padded size
+*/
+static size_t image_section_bytes(size_t inBytes)
+{
+    return (inBytes + 7) & ~(size_t)7;
+}
+
+/*
+* Function to compute the checksum of the image sections (FNV-1a, 64 bit)
+* @param inData -> first byte of the sections
+* @param inBytes -> size of the sections
+* @return checksum
+*/
+static uint64_t image_checksum(const char* inData, size_t inBytes)
+{
+    uint64_t hashValue = 14695981039346656037ull;
+    for (size_t i = 0; i < inBytes; ++i)
+    {
+        hashValue ^= (unsigned char)inData[i];
+        hashValue *= 1099511628211ull;
+    }
+    return hashValue;
+}
+
+/*
+* Function to compute the size of the image sections
+* @param moduleCount -> number of modules
+* @param hashSlotCount -> size of the hash table
+* @param namePoolBytes -> size of the name pool
+* @return bytes after the header
+*/
+static size_t image_payload_bytes(size_t moduleCount, size_t hashSlotCount, size_t namePoolBytes)
+{
+    return 6 * image_section_bytes(moduleCount * sizeof(float)) + image_section_bytes(moduleCount) +
+        image_section_bytes(moduleCount * sizeof(uint32_t)) + image_section_bytes(hashSlotCount * sizeof(int)) +
+        image_section_bytes(namePoolBytes);
+}
+
+/*
+* Function to copy one image section into an array
+* @param ioSection -> start of the section, moved to the next section
+* @param outVec -> array to fill
+* @param count -> number of values in the section
+*/
+template <typename T>
+static void read_image_section(const char*& ioSection, std::vector<T>& outVec, size_t count)
+{
+    const T* data = (const T*)ioSection;
+    outVec.assign(data, data + count);
+    ioSection += image_section_bytes(count * sizeof(T));
+}
+
+/*
+* Function to write the store as a binary module image
+* @param imageFile -> file to write
+* @return bool if the file could be written
+*/
+bool ModuleStore::write_image(const std::string& imageFile) const
+{
+    moduleImageHeader_t header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, MODULEIMAGEMAGIC, sizeof(header.magic));
+    header.version = MODULEIMAGEVERSION;
+    header.byteOrder = 0x01020304;
+    header.moduleCount = (uint32_t)this->size();
+    header.hashSlotCount = (uint32_t)this->hashSlots.size();
+    header.flexibleCount = (uint32_t)this->flexibleCount;
+    header.namePoolBytes = this->namePool.size();
+    header.totalArea = this->totalArea;
+
+    std::vector<char> payload;
+    payload.reserve(image_payload_bytes(header.moduleCount, header.hashSlotCount, header.namePoolBytes));
+    auto appendSection = [&payload](const void* inData, size_t inBytes)
+    {
+        const char* data = (const char*)inData;
+        payload.insert(payload.end(), data, data + inBytes);
+        payload.resize(payload.size() + image_section_bytes(inBytes) - inBytes, 0);
+    };
+    appendSection(this->widthVec.data(), this->widthVec.size() * sizeof(float));
+    appendSection(this->heightVec.data(), this->heightVec.size() * sizeof(float));
+    appendSection(this->areaVec.data(), this->areaVec.size() * sizeof(float));
+    appendSection(this->aspectRatioVec.data(), this->aspectRatioVec.size() * sizeof(float));
+    appendSection(this->minAspectRatioVec.data(), this->minAspectRatioVec.size() * sizeof(float));
+    appendSection(this->maxAspectRatioVec.data(), this->maxAspectRatioVec.size() * sizeof(float));
+    appendSection(this->rotatableVec.data(), this->rotatableVec.size());
+    appendSection(this->nameOffsetVec.data(), this->nameOffsetVec.size() * sizeof(uint32_t));
+    appendSection(this->hashSlots.data(), this->hashSlots.size() * sizeof(int));
+    appendSection(this->namePool.data(), this->namePool.size());
+    header.payloadBytes = payload.size();
+    header.payloadChecksum = image_checksum(payload.data(), payload.size());
+
+    std::ofstream OUTFH(imageFile, std::ios::binary);
+    if (!OUTFH.is_open())
+    {
+        std::cerr << "Unable to open the module image file: " << imageFile << "\n";
+        return false;
+    }
+    OUTFH.write((const char*)&header, sizeof(header));
+    OUTFH.write(payload.data(), payload.size());
+    return (bool)OUTFH;
+}
+
+/*
+* Function to replace the store with a binary module image
+* @param imageFile -> file written by write_image on the same machine type
+* @return bool if the image is valid (store is unchanged otherwise)
+*
+* Checks: header fields, section sizes, checksum, name offsets inside the pool,
+* hash slots holding valid IDs in a power of 2 table at most half full
+*/
+bool ModuleStore::load_image(const std::string& imageFile)
+{
+    int fd = open(imageFile.c_str(), O_RDONLY);
+    struct stat fileStat;
+    if (fd < 0 || fstat(fd, &fileStat) != 0)
+    {
+        std::cerr << "Unable to open the module image file: " << imageFile << "\n";
+        if (fd >= 0)
+        {
+            close(fd);
+        }
+        return false;
+    }
+    size_t fileBytes = (size_t)fileStat.st_size;
+    void* mapping = (fileBytes >= sizeof(moduleImageHeader_t)) ?
+        mmap(NULL, fileBytes, PROT_READ, MAP_PRIVATE, fd, 0) : MAP_FAILED;
+    close(fd);
+    if (mapping == MAP_FAILED)
+    {
+        std::cerr << "Invalid module image " << imageFile << ": too small or not mappable\n";
+        return false;
+    }
+    const char* image = (const char*)mapping;
+    const moduleImageHeader_t& header = *(const moduleImageHeader_t*)image;
+    const char* payload = image + sizeof(moduleImageHeader_t);
+    size_t moduleCount = header.moduleCount, hashSlotCount = header.hashSlotCount;
+    std::string errorMessage;
+    if (std::memcmp(header.magic, MODULEIMAGEMAGIC, sizeof(header.magic)) != 0 || header.version != MODULEIMAGEVERSION ||
+        header.byteOrder != 0x01020304)
+    {
+        errorMessage = "not a version " + std::to_string(MODULEIMAGEVERSION) + " image of this machine type";
+    }
+    else if (header.payloadBytes != fileBytes - sizeof(moduleImageHeader_t) ||
+        header.payloadBytes != image_payload_bytes(moduleCount, hashSlotCount, header.namePoolBytes))
+    {
+        errorMessage = "truncated or inconsistent sizes";
+    }
+    else if (image_checksum(payload, header.payloadBytes) != header.payloadChecksum)
+    {
+        errorMessage = "checksum mismatch";
+    }
+    else if (hashSlotCount < 2 * moduleCount || hashSlotCount == 0 || (hashSlotCount & (hashSlotCount - 1)) != 0 ||
+        (header.namePoolBytes > 0 && payload[header.payloadBytes - image_section_bytes(header.namePoolBytes) +
+        header.namePoolBytes - 1] != '\0'))
+    {
+        errorMessage = "invalid hash table or name pool";
+    }
+
+    ModuleStore imageStore;
+    if (errorMessage.empty())
+    {
+        const char* section = payload;
+        read_image_section(section, imageStore.widthVec, moduleCount);
+        read_image_section(section, imageStore.heightVec, moduleCount);
+        read_image_section(section, imageStore.areaVec, moduleCount);
+        read_image_section(section, imageStore.aspectRatioVec, moduleCount);
+        read_image_section(section, imageStore.minAspectRatioVec, moduleCount);
+        read_image_section(section, imageStore.maxAspectRatioVec, moduleCount);
+        read_image_section(section, imageStore.rotatableVec, moduleCount);
+        read_image_section(section, imageStore.nameOffsetVec, moduleCount);
+        read_image_section(section, imageStore.hashSlots, hashSlotCount);
+        read_image_section(section, imageStore.namePool, header.namePoolBytes);
+        imageStore.placementXVec.assign(moduleCount, 0);
+        imageStore.placementYVec.assign(moduleCount, 0);
+        imageStore.totalArea = header.totalArea;
+        int usedSlots = 0;
+        for (int slotId : imageStore.hashSlots)
+        {
+            usedSlots += (slotId != -1);
+            if (slotId < -1 || slotId >= (int)moduleCount)
+            {
+                errorMessage = "invalid hash slot";
+                break;
+            }
+        }
+        for (size_t id = 0; id < moduleCount && errorMessage.empty(); ++id)
+        {
+            if (imageStore.nameOffsetVec[id] >= header.namePoolBytes)
+            {
+                errorMessage = "invalid name offset";
+            }
+            imageStore.flexibleCount += imageStore.is_flexible((int)id) ? 1 : 0;
+        }
+        if (errorMessage.empty() && (usedSlots != (int)moduleCount || imageStore.flexibleCount != (int)header.flexibleCount))
+        {
+            errorMessage = "module count mismatch";
+        }
+    }
+    munmap(mapping, fileBytes);
+    if (!errorMessage.empty())
+    {
+        std::cerr << "Invalid module image " << imageFile << ": " << errorMessage << "\n";
+        return false;
+    }
+    *this = std::move(imageStore);
+    return true;
+}
+
+/*
+* Function to check if a file is a module image
+* @param inputFile -> file to check
+* @return bool if the file starts with MODULEIMAGEMAGIC
+*/
+bool ModuleStore::is_image_file(const std::string& inputFile)
+{
+    char magic[sizeof(MODULEIMAGEMAGIC) - 1];
+    std::ifstream FH(inputFile, std::ios::binary);
+    return FH.read(magic, sizeof(magic)) && std::memcmp(magic, MODULEIMAGEMAGIC, sizeof(magic)) == 0;
+}
@@ -0,0 +1,226 @@
+#ifndef __MODULE_STORE_H__
+#define __MODULE_STORE_H__
+
+#include <vector>
+#include <string>
+#include <cstdint>
+
+/*
+* Binary module image (sa --compile)
+*/
+// First bytes of an image file
+#define MODULEIMAGEMAGIC "SAMODIMG"
+// Format version (layout of moduleImageHeader_t and the sections)
+#define MODULEIMAGEVERSION 1
+
+/*
+* Type for the header of a module image
+*
+* Sections after the header, each padded to 8 bytes, native byte order:
+*   float width, height, area, aspect ratio, min aspect ratio, max aspect ratio [moduleCount]
+*   uint8 rotatable [moduleCount], uint32 name offset [moduleCount]
+*   int32 hash slots [hashSlotCount], char name pool [namePoolBytes]
+*/
+typedef struct moduleImageHeader_t
+{
+    char magic[8];
+    uint32_t version;
+    // 0x01020304 as written (byte order check)
+    uint32_t byteOrder;
+    uint32_t moduleCount;
+    uint32_t hashSlotCount;
+    uint32_t flexibleCount;
+    uint32_t reserved;
+    uint64_t namePoolBytes;
+    uint64_t payloadBytes;
+    // FNV-1a of the sections
+    uint64_t payloadChecksum;
+    double totalArea;
+} moduleImageHeader_t;
+
+/*
+* Structure-of-arrays table for the circuit modules
+*
+* Every module gets a dense ID (0..size-1) in insertion order.
+* Hot data (width, height, area, aspect ratio, placement) lives in
+* contiguous float arrays indexed by that ID, and the names are
+* interned into a single character pool.
+*
+* Hot data per module: 6 floats + 1 name offset = 28 bytes
+* Name lookup uses an open addressing table of IDs into the pool,
+* so no per-module heap allocation is done.
+*
+* Shape data (aspect ratio bounds, rotation flag) of soft modules is
+* kept in separate arrays and only read when flexible modules exist.
+*/
+class ModuleStore
+{
+private:
+    // Module dimensions per ID
+    std::vector<float> widthVec;
+    std::vector<float> heightVec;
+    std::vector<float> areaVec;
+    std::vector<float> aspectRatioVec;
+    // Module placement (bottom left corner) per ID
+    std::vector<float> placementXVec;
+    std::vector<float> placementYVec;
+    // Shape data per ID (min == max and not rotatable => hard module)
+    std::vector<float> minAspectRatioVec;
+    std::vector<float> maxAspectRatioVec;
+    std::vector<uint8_t> rotatableVec;
+    // Number of modules with shape freedom (soft or rotatable)
+    int flexibleCount;
+    // Sum of the module areas
+    double totalArea;
+    // Interned names: all names back to back, each '\0' terminated
+    std::vector<char> namePool;
+    // Offset of name in namePool per ID
+    std::vector<uint32_t> nameOffsetVec;
+    // Open addressing hash table of IDs (-1 for empty slot)
+    std::vector<int> hashSlots;
+
+    /*
+    * Function to hash a name (FNV-1a)
+    * @param inName -> name characters
+    * @param inLength -> number of characters
+    * @return hash value
+    */
+    static uint32_t hash_name(const char* inName, size_t inLength);
+
+    /*
+    * Function to find the hash slot for a name
+    * @param inName -> name characters
+    * @param inLength -> number of characters
+    * @return slot index (either holding the name or the empty slot to use)
+    */
+    size_t find_slot(const char* inName, size_t inLength) const;
+
+    /*
+    * Function to grow and rebuild the hash table
+    */
+    void rehash();
+
+public:
+
+    /*
+    * Base constructor
+    */
+    ModuleStore();
+
+    /*
+    * Function to reserve space for modules
+    * @param size -> number of modules expected
+    * @param nameBytes -> expected total bytes of names (0 to skip)
+    */
+    void reserve(int size, size_t nameBytes = 0);
+
+    /*
+    * Function to add module to the store
+    * @param inName -> name of module
+    * @param inArea -> area of module
+    * @param inAspectRatio -> aspect ratio (w/h) of module
+    * @param inWidth -> width of module
+    * @param inHeight -> height of module
+    * @return dense ID of module
+    *
+    * NOTE: Adding an existing name overwrites its data and keeps the ID
+    */
+    int add_module(const std::string& inName, float inArea, float inAspectRatio, float inWidth, float inHeight);
+
+    /*
+    * Function to find the ID of a module
+    * @param inName -> name of module
+    * @return dense ID, -1 if not present
+    */
+    int find_id(const std::string& inName) const;
+
+    /*
+    * Function to get number of modules in store
+    */
+    int size() const { return (int)this->widthVec.size(); }
+
+    /*
+    * Getters for module data by ID
+    */
+    float width(int id) const { return this->widthVec[id]; }
+    float height(int id) const { return this->heightVec[id]; }
+    float area(int id) const { return this->areaVec[id]; }
+
+    /*
+    * Getter for the sum of the module areas
+    */
+    double total_area() const { return this->totalArea; }
+    float aspect_ratio(int id) const { return this->aspectRatioVec[id]; }
+    float placement_x(int id) const { return this->placementXVec[id]; }
+    float placement_y(int id) const { return this->placementYVec[id]; }
+    const char* name(int id) const { return &this->namePool[this->nameOffsetVec[id]]; }
+    float min_aspect_ratio(int id) const { return this->minAspectRatioVec[id]; }
+    float max_aspect_ratio(int id) const { return this->maxAspectRatioVec[id]; }
+    bool is_rotatable(int id) const { return this->rotatableVec[id] != 0; }
+
+    /*
+    * Function to check if the module can change shape
+    * @param id -> module ID
+    * @return bool if module is soft or rotatable
+    */
+    bool is_flexible(int id) const
+    {
+        return this->rotatableVec[id] != 0 || this->minAspectRatioVec[id] < this->maxAspectRatioVec[id];
+    }
+
+    /*
+    * Function to check if any module can change shape
+    * @return bool if shape curves are needed to compute area
+    */
+    bool has_flexible_modules() const { return this->flexibleCount > 0; }
+
+    /*
+    * Function to update the shape bounds of a module
+    * @param id -> module ID
+    * @param inMinAspectRatio -> minimum aspect ratio (w/h)
+    * @param inMaxAspectRatio -> maximum aspect ratio (w/h)
+    * @param inRotatable -> if module can be rotated by 90 degrees
+    */
+    void set_shape_bounds(int id, float inMinAspectRatio, float inMaxAspectRatio, bool inRotatable);
+
+    /*
+    * Function to update module dimensions by ID
+    */
+    void set_dimensions(int id, float inWidth, float inHeight);
+
+    /*
+    * Function to update module placement by ID
+    */
+    void set_placement(int id, float inX, float inY);
+
+    /*
+    * Function to clear the placement of all modules
+    */
+    void clear_placement();
+
+    /*
+    * Function to write the store as a binary module image
+    * @param imageFile -> file to write
+    * @return bool if the file could be written
+    */
+    bool write_image(const std::string& imageFile) const;
+
+    /*
+    * Function to replace the store with a binary module image
+    * @param imageFile -> file written by write_image on the same machine type
+    * @return bool if the image is valid (store is unchanged otherwise)
+    *
+    * NOTE: The file is memory mapped and each section is copied into its array
+    * in one go: no parsing, no hashing, no per module insertion
+    */
+    bool load_image(const std::string& imageFile);
+
+    /*
+    * Function to check if a file is a module image
+    * @param inputFile -> file to check
+    * @return bool if the file starts with MODULEIMAGEMAGIC
+    */
+    static bool is_image_file(const std::string& inputFile);
+};
+
+#endif // !__MODULE_STORE_H__
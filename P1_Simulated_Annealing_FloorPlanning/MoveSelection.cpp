@@ -0,0 +1,128 @@
+
+#include <iomanip>
+#include <sstream>
+
+#include "MoveSelection.h"
+#include "PolishExpression.h"
+
+/*
+* Function to record the outcome of a move
+* @param moveType -> move type (1..moveTypeCount)
+* @param isApplied -> if the move changed the state
+* @param isAccepted -> if the move was kept
+* @param delCost -> change in cost (valid if applied)
+* @param nanoseconds -> time spent on the move
+*/
+void MoveStatistics::record(int moveType, bool isApplied, bool isAccepted, float delCost, long long nanoseconds)
+{
+    moveStats_t& currStats = this->statsList[moveType - 1];
+    ++currStats.attempts;
+    currStats.nanoseconds += nanoseconds;
+    if (!isApplied)
+    {
+        ++currStats.failed;
+        return;
+    }
+    if (isAccepted)
+    {
+        ++currStats.accepted;
+        if (delCost < 0)
+        {
+            currStats.improvement -= delCost;
+        }
+    }
+}
+
+/*
+* Function to pick the next move type
+* @param inTemp -> temperature
+* @param maxTemp -> maximum temperature
+* @param randPercent -> uniform random draw in [0, 99]
+* @return move type (1..moveTypeCount)
+*/
+int ScheduledMoves::select(float inTemp, float maxTemp, int randPercent)
+{
+    return select_move(inTemp, maxTemp, randPercent);
+}
+
+AdaptiveMoves::AdaptiveMoves(int moveTypeCount)
+    : MoveStatistics(moveTypeCount), probabilityList(moveTypeCount, 1.0f / moveTypeCount),
+    windowImprovement(moveTypeCount, 0), windowNanoseconds(moveTypeCount, 0), stepStartList(moveTypeCount)
+{
+}
+
+/*
+* Function to pick the next move type
+* @param inTemp -> temperature (unused)
+* @param maxTemp -> maximum temperature (unused)
+* @param randPercent -> uniform random draw in [0, 99]
+* @return move type (1..moveTypeCount)
+*/
+int AdaptiveMoves::select(float, float, int randPercent)
+{
+    float draw = randPercent / 100.0f;
+    int lastType = (int)this->probabilityList.size();
+    for (int i = 0; i < lastType - 1; ++i)
+    {
+        draw -= this->probabilityList[i];
+        if (draw < 0)
+        {
+            return i + 1;
+        }
+    }
+    return lastType;
+}
+
+/*
+* Function called after each temperature step: update the probabilities
+*/
+void AdaptiveMoves::end_step()
+{
+    int moveTypeCount = (int)this->statsList.size();
+    std::vector<double> rateList(moveTypeCount, 0);
+    double rateSum = 0;
+    for (int i = 0; i < moveTypeCount; ++i)
+    {
+        const moveStats_t& currStats = this->statsList[i];
+        moveStats_t& stepStart = this->stepStartList[i];
+        this->windowImprovement[i] = ADAPTIVEDECAY * this->windowImprovement[i] + (currStats.improvement - stepStart.improvement);
+        this->windowNanoseconds[i] = ADAPTIVEDECAY * this->windowNanoseconds[i] + (currStats.nanoseconds - stepStart.nanoseconds);
+        stepStart = currStats;
+        if (this->windowNanoseconds[i] > 0)
+        {
+            rateList[i] = this->windowImprovement[i] / this->windowNanoseconds[i];
+        }
+        rateSum += rateList[i];
+    }
+    // No improvement seen => keep the current probabilities
+    if (rateSum <= 0)
+    {
+        return;
+    }
+    float freeShare = 1.0f - moveTypeCount * ADAPTIVEMINPROBABILITY;
+    for (int i = 0; i < moveTypeCount; ++i)
+    {
+        this->probabilityList[i] = ADAPTIVEMINPROBABILITY + freeShare * (float)(rateList[i] / rateSum);
+    }
+}
+
+/*
+* Function to print the per move type statistics
+* @param statsList -> statistics (index 0 is move type 1)
+* @param outStream -> stream to print to
+*/
+void print_move_stats(const std::vector<moveStats_t>& statsList, std::ostream& outStream)
+{
+    outStream << "Move statistics (type: attempts, failed, accepted, cost decrease, ns/move, decrease/us):\n";
+    for (size_t i = 0; i < statsList.size(); ++i)
+    {
+        const moveStats_t& currStats = statsList[i];
+        double nsPerMove = currStats.attempts ? (double)currStats.nanoseconds / currStats.attempts : 0;
+        double ratePerUs = currStats.nanoseconds ? 1000 * currStats.improvement / currStats.nanoseconds : 0;
+        // Formatted locally, the precision would otherwise stay on outStream (std::cout)
+        std::ostringstream rateStream;
+        rateStream << std::fixed << std::setprecision(1) << nsPerMove << ", " << std::setprecision(4) << ratePerUs;
+        outStream << "  M" << i + 1 << ": " << currStats.attempts << ", " << currStats.failed << ", "
+            << currStats.accepted << ", " << currStats.improvement << ", " << rateStream.str() << "\n";
+    }
+}
@@ -0,0 +1,129 @@
+#ifndef __MOVE_SELECTION_H__
+#define __MOVE_SELECTION_H__
+
+#include <vector>
+#include <ostream>
+
+/*
+* Adaptive selection constraints
+*/
+// Minimum probability of each move type (keeps sampling all moves)
+#define ADAPTIVEMINPROBABILITY 0.05f
+// Weight of the older statistics after each temperature step
+#define ADAPTIVEDECAY 0.5f
+
+/*
+* Type for the statistics of one move type
+*/
+typedef struct moveStats_t
+{
+    // Moves drawn, moves that could not be applied, accepted moves
+    long long attempts = 0;
+    long long failed = 0;
+    long long accepted = 0;
+    // Total cost decrease of the accepted downhill moves
+    double improvement = 0;
+    // Time spent applying, evaluating and rolling back the moves
+    long long nanoseconds = 0;
+} moveStats_t;
+
+/*
+* Base of the move policies: per move type statistics
+*/
+class MoveStatistics
+{
+protected:
+    // Index 0 is move type 1
+    std::vector<moveStats_t> statsList;
+
+public:
+    explicit MoveStatistics(int moveTypeCount) : statsList(moveTypeCount) {}
+
+    /*
+    * Function to record the outcome of a move
+    * @param moveType -> move type (1..moveTypeCount)
+    * @param isApplied -> if the move changed the state
+    * @param isAccepted -> if the move was kept
+    * @param delCost -> change in cost (valid if applied)
+    * @param nanoseconds -> time spent on the move
+    */
+    void record(int moveType, bool isApplied, bool isAccepted, float delCost, long long nanoseconds);
+
+    /*
+    * Getter for the statistics of all move types
+    */
+    const std::vector<moveStats_t>& get_stats() const { return this->statsList; }
+};
+
+/*
+* Move policy: fixed probability tables picked by temperature (select_move)
+*/
+class ScheduledMoves : public MoveStatistics
+{
+public:
+    explicit ScheduledMoves(int moveTypeCount) : MoveStatistics(moveTypeCount) {}
+
+    /*
+    * Function to pick the next move type
+    * @param inTemp -> temperature
+    * @param maxTemp -> maximum temperature
+    * @param randPercent -> uniform random draw in [0, 99]
+    * @return move type (1..moveTypeCount)
+    */
+    int select(float inTemp, float maxTemp, int randPercent);
+
+    /*
+    * Function called after each temperature step
+    */
+    void end_step() {}
+};
+
+/*
+* Move policy: probability matching on the cost decrease per nanosecond
+*
+* Logic: Every temperature step the probability of each move type is set in
+* proportion to its improvement rate (cost decrease / time) over the decayed
+* statistics, with ADAPTIVEMINPROBABILITY kept for every move type.
+* Moves that often fail to apply spend time without improving and lose share.
+*/
+class AdaptiveMoves : public MoveStatistics
+{
+private:
+    std::vector<float> probabilityList;
+    // Decayed improvement and time since the start
+    std::vector<double> windowImprovement;
+    std::vector<double> windowNanoseconds;
+    // Statistics at the last temperature step
+    std::vector<moveStats_t> stepStartList;
+
+public:
+    explicit AdaptiveMoves(int moveTypeCount);
+
+    /*
+    * Function to pick the next move type
+    * @param inTemp -> temperature (unused)
+    * @param maxTemp -> maximum temperature (unused)
+    * @param randPercent -> uniform random draw in [0, 99]
+    * @return move type (1..moveTypeCount)
+    */
+    int select(float inTemp, float maxTemp, int randPercent);
+
+    /*
+    * Function called after each temperature step: update the probabilities
+    */
+    void end_step();
+
+    /*
+    * Getter for the current probabilities (index 0 is move type 1)
+    */
+    const std::vector<float>& get_probabilities() const { return this->probabilityList; }
+};
+
+/*
+* Function to print the per move type statistics
+* @param statsList -> statistics (index 0 is move type 1)
+* @param outStream -> stream to print to
+*/
+void print_move_stats(const std::vector<moveStats_t>& statsList, std::ostream& outStream);
+
+#endif // !__MOVE_SELECTION_H__
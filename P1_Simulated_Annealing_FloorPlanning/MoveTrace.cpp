@@ -0,0 +1,317 @@
+
+#include <iostream>
+#include <chrono>
+#include <cstring>
+#include <limits>
+
+#include "MoveTrace.h"
+
+/*
+* Function to write a value in host byte order
+*/
+template <typename T>
+static void write_value(std::ofstream& outStream, T inValue)
+{
+    outStream.write(reinterpret_cast<const char*>(&inValue), sizeof(T));
+}
+
+/*
+* Function to read a value in host byte order
+* @return bool if the value could be read
+*/
+template <typename T>
+static bool read_value(std::ifstream& inStream, T& outValue)
+{
+    return (bool)inStream.read(reinterpret_cast<char*>(&outValue), sizeof(T));
+}
+
+/*
+* Function to compute the checksum of the module names (FNV-1a, 64 bit)
+* @param moduleStore -> modules in ID order
+* @return checksum, same input file => same checksum
+*/
+static uint64_t module_name_checksum(const ModuleStore& moduleStore)
+{
+    uint64_t hashValue = 14695981039346656037ull;
+    for (int id = 0; id < moduleStore.size(); ++id)
+    {
+        // Terminating NUL included => "ab","c" differs from "a","bc"
+        const char* currName = moduleStore.name(id);
+        size_t nameLength = std::strlen(currName);
+        for (size_t i = 0; i <= nameLength; ++i)
+        {
+            hashValue ^= (unsigned char)currName[i];
+            hashValue *= 1099511628211ull;
+        }
+    }
+    return hashValue;
+}
+
+/*
+* Function to check the start expression of a trace
+* @param tokenList -> tokens of the header (module ID, TRACE_H_TOKEN, TRACE_V_TOKEN)
+* @param moduleCount -> number of modules of the input
+* @param windowBegin -> recorded move window begin
+* @param windowEnd -> recorded move window end (-1 => end of expression)
+* @return bool if the tokens form a normalized polish expression of all the modules and the window is in range
+*/
+static bool check_start_expression(const std::vector<int32_t>& tokenList, int moduleCount, int32_t windowBegin, int32_t windowEnd)
+{
+    std::vector<bool> isSeen(moduleCount, false);
+    int operandCount = 0;
+    int operatorCount = 0;
+    for (size_t i = 0; i < tokenList.size(); ++i)
+    {
+        int32_t token = tokenList[i];
+        if (token >= 0)
+        {
+            // Every module exactly once
+            if (isSeen[token])
+            {
+                return false;
+            }
+            isSeen[token] = true;
+            ++operandCount;
+        }
+        else
+        {
+            // Normalized: no HH or VV
+            if (i > 0 && tokenList[i - 1] == token)
+            {
+                return false;
+            }
+            ++operatorCount;
+        }
+        // Balloting property at every prefix
+        if (operandCount <= operatorCount)
+        {
+            return false;
+        }
+    }
+    int tokenCount = (int)tokenList.size();
+    return operandCount == moduleCount && windowBegin >= 0 && windowBegin < tokenCount &&
+        (windowEnd == -1 || (windowBegin < windowEnd && windowEnd <= tokenCount));
+}
+
+/*
+* Constructor: opens the trace file
+* @param traceFile -> file to write
+*/
+MoveTraceWriter::MoveTraceWriter(const std::string& traceFile)
+    : traceStream(traceFile, std::ios::binary)
+{
+    this->recordCount = 0;
+    if (!this->traceStream.is_open())
+    {
+        std::cerr << "Unable to open the trace file " << traceFile << "\n";
+    }
+}
+
+/*
+* Function to write the header (start expression and move window)
+* @param inExpression -> expression before the first move
+*/
+void MoveTraceWriter::write_header(PolishExpression& inExpression)
+{
+    const ModuleStore& moduleStore = inExpression.get_module_store();
+    std::vector<std::string> currExpression = inExpression.get_polish_expression();
+    int windowBegin, windowEnd;
+    inExpression.get_move_window(windowBegin, windowEnd);
+    this->traceStream.write(TRACEMAGIC, std::strlen(TRACEMAGIC));
+    write_value<uint32_t>(this->traceStream, moduleStore.size());
+    write_value<uint64_t>(this->traceStream, module_name_checksum(moduleStore));
+    write_value<int32_t>(this->traceStream, windowBegin);
+    write_value<int32_t>(this->traceStream, windowEnd);
+    write_value<uint32_t>(this->traceStream, currExpression.size());
+    for (auto& element : currExpression)
+    {
+        int32_t token = is_operator(element) ?
+            (is_vertical_partition(element) ? TRACE_V_TOKEN : TRACE_H_TOKEN) : moduleStore.find_id(element);
+        write_value<int32_t>(this->traceStream, token);
+    }
+}
+
+/*
+* Function to write one record
+*/
+void MoveTraceWriter::write_record(const traceRecord_t& inRecord)
+{
+    write_value<uint8_t>(this->traceStream, inRecord.kind);
+    write_value<uint8_t>(this->traceStream, inRecord.flags);
+    write_value<int32_t>(this->traceStream, inRecord.index1);
+    write_value<int32_t>(this->traceStream, inRecord.index2);
+    write_value<float>(this->traceStream, inRecord.costBound);
+    ++this->recordCount;
+}
+
+/*
+* Function to record a move and its decision
+* @param moveType -> move type (1..3)
+* @param isApplied -> if the move changed the expression
+* @param isAccepted -> if the move was kept
+* @param index1 -> first index of the move (get_last_move)
+* @param index2 -> second index of the move (get_last_move)
+* @param costBound -> bound given to the evaluation
+*/
+void MoveTraceWriter::record_move(int moveType, bool isApplied, bool isAccepted, int index1, int index2, float costBound)
+{
+    traceRecord_t currRecord;
+    currRecord.kind = (uint8_t)moveType;
+    currRecord.flags = (isApplied ? TRACE_APPLIED : 0) | (isAccepted ? TRACE_ACCEPTED : 0);
+    currRecord.index1 = index1;
+    currRecord.index2 = index2;
+    currRecord.costBound = costBound;
+    this->write_record(currRecord);
+}
+
+/*
+* Function to record the end of a temperature step
+*/
+void MoveTraceWriter::record_step()
+{
+    traceRecord_t currRecord = { TRACE_STEP, 0, -1, -1, 0 };
+    this->write_record(currRecord);
+}
+
+/*
+* Function to close the trace
+* @param bestCost -> best cost of the anneal (checked by the replay)
+*/
+void MoveTraceWriter::finish(float bestCost)
+{
+    traceRecord_t currRecord = { TRACE_END, 0, -1, -1, bestCost };
+    this->write_record(currRecord);
+    this->traceStream.close();
+}
+
+/*
+* Function to replay a move trace
+* @param ioExpression -> expression holding the modules of the traced run, left at the best expression
+* @param traceFile -> trace written by MoveTraceWriter
+* @param logStream -> stream for the step times
+* @return result of the replay
+*/
+replayResult_t replay_move_trace(PolishExpression& ioExpression, const std::string& traceFile, std::ostream& logStream)
+{
+    replayResult_t result;
+    std::ifstream traceStream(traceFile, std::ios::binary);
+    if (!traceStream.is_open())
+    {
+        std::cerr << "Unable to open the trace file " << traceFile << "\n";
+        return result;
+    }
+
+    // Header: modules must match the traced run
+    const ModuleStore& moduleStore = ioExpression.get_module_store();
+    char magic[sizeof(TRACEMAGIC) - 1];
+    uint32_t moduleCount, tokenCount;
+    uint64_t nameChecksum;
+    int32_t windowBegin, windowEnd;
+    if (!traceStream.read(magic, sizeof(magic)) || std::memcmp(magic, TRACEMAGIC, sizeof(magic)) != 0 ||
+        !read_value(traceStream, moduleCount) || !read_value(traceStream, nameChecksum) || !read_value(traceStream, windowBegin) ||
+        !read_value(traceStream, windowEnd) || !read_value(traceStream, tokenCount))
+    {
+        std::cerr << "Invalid trace file " << traceFile << "\n";
+        return result;
+    }
+    if ((int)moduleCount != moduleStore.size() || tokenCount != 2 * moduleCount - 1)
+    {
+        std::cerr << "Trace was recorded for " << moduleCount << " modules, input has " << moduleStore.size() << "\n";
+        return result;
+    }
+    if (nameChecksum != module_name_checksum(moduleStore))
+    {
+        std::cerr << "Trace was recorded for other modules than the ones of the input\n";
+        return result;
+    }
+    std::vector<int32_t> tokenList(tokenCount);
+    for (uint32_t i = 0; i < tokenCount; ++i)
+    {
+        if (!read_value(traceStream, tokenList[i]) || tokenList[i] < TRACE_V_TOKEN || tokenList[i] >= (int32_t)moduleCount)
+        {
+            std::cerr << "Invalid trace file " << traceFile << "\n";
+            return result;
+        }
+    }
+    // Anything else would crash the evaluation
+    if (!check_start_expression(tokenList, (int)moduleCount, windowBegin, windowEnd))
+    {
+        std::cerr << "Invalid start expression or move window in trace file " << traceFile << "\n";
+        return result;
+    }
+    std::vector<std::string> startExpression;
+    for (int32_t token : tokenList)
+    {
+        startExpression.push_back((token == TRACE_H_TOKEN) ? H_t : (token == TRACE_V_TOKEN) ? V_t : moduleStore.name(token));
+    }
+    ioExpression.update_expression(startExpression);
+    ioExpression.set_move_window(windowBegin, windowEnd);
+
+    // Records: same work as the annealer loop
+    PolishExpression::state_t currState, bestState;
+    float currCost = ioExpression.compute_area();
+    float bestCost = currCost;
+    ioExpression.save_state(bestState);
+    std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+    std::chrono::steady_clock::time_point stepTime = startTime;
+    traceRecord_t currRecord;
+    bool isFinished = false;
+    while (read_value(traceStream, currRecord.kind) && read_value(traceStream, currRecord.flags) &&
+        read_value(traceStream, currRecord.index1) && read_value(traceStream, currRecord.index2) &&
+        read_value(traceStream, currRecord.costBound))
+    {
+        if (currRecord.kind == TRACE_END)
+        {
+            result.recordedBestCost = currRecord.costBound;
+            isFinished = true;
+            break;
+        }
+        if (currRecord.kind == TRACE_STEP)
+        {
+            ++result.steps;
+            std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+            logStream << "Replay step #" << result.steps << ": " << std::chrono::duration<double>(now - stepTime).count()
+                << "s, Cost Value = " << bestCost << "\n";
+            stepTime = now;
+            continue;
+        }
+        // Moves that failed to apply did not change the expression
+        if (!(currRecord.flags & TRACE_APPLIED))
+        {
+            continue;
+        }
+        ioExpression.save_state(currState);
+        if (!ioExpression.apply_recorded_move(currRecord.kind, currRecord.index1, currRecord.index2))
+        {
+            std::cerr << "Trace move " << result.movesReplayed << " does not apply to the expression\n";
+            return result;
+        }
+        ++result.movesReplayed;
+        float newCost = (currRecord.costBound < std::numeric_limits<float>::infinity()) ?
+            ioExpression.compute_bounded_area(currRecord.costBound) : ioExpression.compute_area();
+        if (currRecord.flags & TRACE_ACCEPTED)
+        {
+            currCost = newCost;
+            if (newCost < bestCost)
+            {
+                ioExpression.save_state(bestState);
+                bestCost = newCost;
+            }
+        }
+        else
+        {
+            ioExpression.restore_state(currState);
+        }
+    }
+    result.runTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    if (!isFinished)
+    {
+        std::cerr << "Trace file " << traceFile << " is truncated\n";
+        return result;
+    }
+    ioExpression.restore_state(bestState);
+    ioExpression.set_move_window(0, -1);
+    result.bestCost = bestCost;
+    result.isValid = true;
+    return result;
+}
@@ -0,0 +1,135 @@
+#ifndef __MOVE_TRACE_H__
+#define __MOVE_TRACE_H__
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <ostream>
+#include <cstdint>
+
+#include "PolishExpression.h"
+
+/*
+* Trace file layout (little endian, as written by the host):
+*   header: "SATRACE2", uint32 module count, uint64 module name checksum (FNV-1a over the names
+*           in ID order, NUL terminated), int32 window begin, int32 window end,
+*           uint32 token count, int32 tokens (module ID, TRACE_H_TOKEN, TRACE_V_TOKEN)
+*   records: uint8 kind, uint8 flags, int32 index1, int32 index2, float cost bound
+*     kind 1..3 => move type, TRACE_STEP => end of a temperature step,
+*     TRACE_END => end of trace (cost bound holds the best cost)
+*/
+#define TRACEMAGIC "SATRACE2"
+#define TRACE_H_TOKEN -1
+#define TRACE_V_TOKEN -2
+#define TRACE_STEP 0
+#define TRACE_END 255
+// Record flags
+#define TRACE_APPLIED 1
+#define TRACE_ACCEPTED 2
+// Bytes per record
+#define TRACERECORDSIZE 14
+
+/*
+* Type for one trace record
+*/
+typedef struct traceRecord_t
+{
+    uint8_t kind;
+    uint8_t flags;
+    int32_t index1;
+    int32_t index2;
+    // Largest accepted cost used for the evaluation (infinity => full evaluation)
+    float costBound;
+} traceRecord_t;
+
+/*
+* Writer of the move trace of one anneal
+*/
+class MoveTraceWriter
+{
+private:
+    std::ofstream traceStream;
+    long long recordCount;
+
+    /*
+    * Function to write one record
+    */
+    void write_record(const traceRecord_t& inRecord);
+
+public:
+
+    /*
+    * Constructor: opens the trace file
+    * @param traceFile -> file to write
+    */
+    explicit MoveTraceWriter(const std::string& traceFile);
+
+    /*
+    * Getter for the file state
+    */
+    bool is_open() const { return this->traceStream.is_open(); }
+
+    /*
+    * Function to write the header (start expression and move window)
+    * @param inExpression -> expression before the first move
+    */
+    void write_header(PolishExpression& inExpression);
+
+    /*
+    * Function to record a move and its decision
+    * @param moveType -> move type (1..3)
+    * @param isApplied -> if the move changed the expression
+    * @param isAccepted -> if the move was kept
+    * @param index1 -> first index of the move (get_last_move)
+    * @param index2 -> second index of the move (get_last_move)
+    * @param costBound -> bound given to the evaluation
+    */
+    void record_move(int moveType, bool isApplied, bool isAccepted, int index1, int index2, float costBound);
+
+    /*
+    * Function to record the end of a temperature step
+    */
+    void record_step();
+
+    /*
+    * Function to close the trace
+    * @param bestCost -> best cost of the anneal (checked by the replay)
+    */
+    void finish(float bestCost);
+
+    /*
+    * Getter for the number of records written
+    */
+    long long get_record_count() const { return this->recordCount; }
+};
+
+/*
+* Type for the outcome of a replay
+*/
+typedef struct replayResult_t
+{
+    bool isValid = false;
+    long long movesReplayed = 0;
+    int steps = 0;
+    float bestCost = 0;
+    // Best cost stored in the trace
+    float recordedBestCost = 0;
+    // Wall time of the replay loop in seconds
+    double runTime = 0;
+} replayResult_t;
+
+/*
+* Function to replay a move trace
+* @param ioExpression -> expression holding the modules of the traced run, left at the best expression
+* @param traceFile -> trace written by MoveTraceWriter
+* @param logStream -> stream for the step times
+* @return result of the replay
+*
+* Logic: Same save, move, evaluate and rollback sequence as the annealer with the
+* recorded indices, bounds and decisions (no random draws, no Metropolis test).
+* The start expression is checked to be a normalized polish expression of the input
+* modules (names checksum, every ID once, ballot property, no HH/VV) before it is used
+*/
+replayResult_t replay_move_trace(PolishExpression& ioExpression, const std::string& traceFile, std::ostream& logStream);
+
+#endif // !__MOVE_TRACE_H__
@@ -0,0 +1,90 @@
+
+#include <iostream>
+#include <algorithm>
+
+#include "Netlist.h"
+#include "ModuleParser.h"
+
+/*
+* Base constructor
+*/
+Netlist::Netlist()
+{
+    this->netOffsets.push_back(0);
+}
+
+/*
+* Function to add a net
+* @param inName -> name of net
+* @param inModules -> module IDs on the net
+*/
+void Netlist::add_net(const std::string& inName, const std::vector<int>& inModules)
+{
+    this->netNames.push_back(inName);
+    this->pinModules.insert(this->pinModules.end(), inModules.begin(), inModules.end());
+    this->netOffsets.push_back((int)this->pinModules.size());
+}
+
+/*
+* Function to compute the half perimeter wirelength of the placed modules
+* @param moduleStore -> modules with their placement
+* @return sum over the nets of the half perimeter of the box around the module centers
+*/
+double Netlist::half_perimeter_wirelength(const ModuleStore& moduleStore) const
+{
+    double totalLength = 0;
+    for (int net = 0; net < this->size(); ++net)
+    {
+        float minX = 0, maxX = 0, minY = 0, maxY = 0;
+        for (int pin = this->pin_begin(net); pin < this->pin_end(net); ++pin)
+        {
+            int id = this->pin_module(pin);
+            float centerX = moduleStore.placement_x(id) + moduleStore.width(id) / 2;
+            float centerY = moduleStore.placement_y(id) + moduleStore.height(id) / 2;
+            bool isFirst = (pin == this->pin_begin(net));
+            minX = isFirst ? centerX : std::min(minX, centerX);
+            maxX = isFirst ? centerX : std::max(maxX, centerX);
+            minY = isFirst ? centerY : std::min(minY, centerY);
+            maxY = isFirst ? centerY : std::max(maxY, centerY);
+        }
+        totalLength += (maxX - minX) + (maxY - minY);
+    }
+    return totalLength;
+}
+
+/*
+* Function to read the netlist file
+* @param inputFile -> file to read
+* @param moduleStore -> modules the nets connect
+* @return bool if the file is valid
+*/
+bool Netlist::read_netlist_file(const std::string& inputFile, const ModuleStore& moduleStore)
+{
+    std::vector<std::vector<std::string> > lineList;
+    if (!read_split_lines(inputFile, lineList))
+    {
+        return false;
+    }
+    std::vector<int> netModules;
+    for (auto& currentLineVec : lineList)
+    {
+        if (currentLineVec.size() < 3)
+        {
+            std::cerr << "Incorrect format for netlist file: <net_name> <module_name> <module_name> [...]\n";
+            return false;
+        }
+        netModules.clear();
+        for (size_t i = 1; i < currentLineVec.size(); ++i)
+        {
+            int id = moduleStore.find_id(currentLineVec[i]);
+            if (id == -1)
+            {
+                std::cerr << "Unknown module " << currentLineVec[i] << " on net " << currentLineVec[0] << "\n";
+                return false;
+            }
+            netModules.push_back(id);
+        }
+        this->add_net(currentLineVec[0], netModules);
+    }
+    return true;
+}
@@ -0,0 +1,65 @@
+#ifndef __NETLIST_H__
+#define __NETLIST_H__
+
+#include <string>
+#include <vector>
+
+#include "ModuleStore.h"
+
+/*
+* Nets between the modules (module IDs of a ModuleStore)
+*
+* Pins of all nets are stored back to back (CSR layout):
+* net i connects pinModules[netOffsets[i] .. netOffsets[i+1]-1]
+*
+* Netlist file format (one net per line):
+*   <net_name> <module_name> <module_name> [<module_name> ...]
+*/
+class Netlist
+{
+private:
+    std::vector<int> pinModules;
+    std::vector<int> netOffsets;
+    std::vector<std::string> netNames;
+
+public:
+
+    /*
+    * Base constructor
+    */
+    Netlist();
+
+    /*
+    * Function to read the netlist file
+    * @param inputFile -> file to read
+    * @param moduleStore -> modules the nets connect
+    * @return bool if the file is valid
+    */
+    bool read_netlist_file(const std::string& inputFile, const ModuleStore& moduleStore);
+
+    /*
+    * Function to add a net
+    * @param inName -> name of net
+    * @param inModules -> module IDs on the net
+    */
+    void add_net(const std::string& inName, const std::vector<int>& inModules);
+
+    /*
+    * Function to compute the half perimeter wirelength of the placed modules
+    * @param moduleStore -> modules with their placement
+    * @return sum over the nets of the half perimeter of the box around the module centers
+    */
+    double half_perimeter_wirelength(const ModuleStore& moduleStore) const;
+
+    /*
+    * Getters for the nets
+    */
+    int size() const { return (int)this->netNames.size(); }
+    bool empty() const { return this->netNames.empty(); }
+    const std::string& net_name(int net) const { return this->netNames[net]; }
+    int pin_begin(int net) const { return this->netOffsets[net]; }
+    int pin_end(int net) const { return this->netOffsets[net + 1]; }
+    int pin_module(int pin) const { return this->pinModules[pin]; }
+};
+
+#endif // !__NETLIST_H__
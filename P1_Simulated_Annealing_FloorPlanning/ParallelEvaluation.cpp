@@ -0,0 +1,255 @@
+
+#include <algorithm>
+#include <queue>
+#include <thread>
+#include <atomic>
+
+#include "ParallelEvaluation.h"
+#include "PolishExpression.h"
+
+/*
+* Type for a subtree of the split (expression range [begin, end], room or module at end)
+*/
+typedef struct subtreeRange_t
+{
+    int begin;
+    int end;
+    // Split children (indices in the subtree list, -1 => evaluated by one task)
+    int child1 = -1;
+    int child2 = -1;
+} subtreeRange_t;
+
+/*
+* Function to compute the rooms of one subtree with a stack
+* @param currList -> current expression
+* @param moduleStore -> module details table
+* @param nodeList -> rooms of the whole expression (only [begin, end] is written)
+* @param inRange -> subtree to evaluate
+*/
+static void evaluate_subtree(const std::vector<std::string>& currList, const ModuleStore& moduleStore,
+    std::vector<areaNode_t>& nodeList, const subtreeRange_t& inRange)
+{
+    std::vector<int> nodeStack;
+    for (int index = inRange.begin; index <= inRange.end; ++index)
+    {
+        const std::string& currElement = currList[index];
+        areaNode_t& currNode = nodeList[index];
+        if (is_operator(currElement))
+        {
+            currNode.child2 = nodeStack.back();
+            nodeStack.pop_back();
+            currNode.child1 = nodeStack.back();
+            nodeStack.pop_back();
+            const areaNode_t& module1 = nodeList[currNode.child1];
+            const areaNode_t& module2 = nodeList[currNode.child2];
+            currNode.isHorizontal = is_horizontal_partition(currElement);
+            if (currNode.isHorizontal)
+            {
+                currNode.width = std::max(module1.width, module2.width);
+                currNode.height = module1.height + module2.height;
+            }
+            else
+            {
+                currNode.width = module1.width + module2.width;
+                currNode.height = std::max(module1.height, module2.height);
+            }
+            currNode.moduleId = -1;
+        }
+        else
+        {
+            currNode.moduleId = moduleStore.find_id(currElement);
+            currNode.width = moduleStore.width(currNode.moduleId);
+            currNode.height = moduleStore.height(currNode.moduleId);
+        }
+        nodeStack.push_back(index);
+    }
+}
+
+/*
+* Function to push the placement of a subtree root down to its modules
+* @param moduleStore -> module details table (placement of the subtree modules is written)
+* @param nodeList -> rooms of the whole expression, root of the subtree placed
+* @param inRange -> subtree to place
+*/
+static void place_subtree(ModuleStore& moduleStore, std::vector<areaNode_t>& nodeList, const subtreeRange_t& inRange)
+{
+    for (int i = inRange.end; i >= inRange.begin; --i)
+    {
+        const areaNode_t& currentRoom = nodeList[i];
+        if (currentRoom.moduleId != -1)
+        {
+            moduleStore.set_placement(currentRoom.moduleId, currentRoom.x, currentRoom.y);
+            continue;
+        }
+        areaNode_t& module1 = nodeList[currentRoom.child1];
+        areaNode_t& module2 = nodeList[currentRoom.child2];
+        module1.x = currentRoom.x;
+        module1.y = currentRoom.y;
+        module2.x = currentRoom.isHorizontal ? currentRoom.x : currentRoom.x + module1.width;
+        module2.y = currentRoom.isHorizontal ? currentRoom.y + module1.height : currentRoom.y;
+    }
+}
+
+/*
+* Function to run a task on every task subtree, threads taking the next one (largest first)
+* @param taskList -> subtrees, sorted by decreasing size
+* @param threadCount -> threads to use (the calling thread is one of them)
+* @param runTask -> function run on each subtree
+*/
+template <typename TaskFunction>
+static void run_tasks(const std::vector<subtreeRange_t>& taskList, int threadCount, const TaskFunction& runTask)
+{
+    std::atomic<int> nextTask(0);
+    auto workerLoop = [&taskList, &nextTask, &runTask]()
+    {
+        for (int t = nextTask++; t < (int)taskList.size(); t = nextTask++)
+        {
+            runTask(taskList[t]);
+        }
+    };
+    std::vector<std::thread> workerList;
+    for (int w = 1; w < std::min(threadCount, (int)taskList.size()); ++w)
+    {
+        workerList.push_back(std::thread(workerLoop));
+    }
+    workerLoop();
+    for (auto& worker : workerList)
+    {
+        worker.join();
+    }
+}
+
+/*
+* Function to compute the area of a hard module expression on several threads
+* @param currList -> current expression
+* @param operandCountVec -> operands up to each index (PolishExpression prefix counts)
+* @param operatorCountVec -> operators up to each index
+* @param moduleStore -> module details table (no soft or rotatable modules)
+* @param generatePlotData -> if the placement is written to the module store
+* @param threadCount -> threads to use (0 => hardware concurrency)
+* @param outline -> fixed outline (NULL => none), adds the penalty for the area outside it
+* @param outChipBox -> chip box of the root room (NULL => not needed)
+* @return float of area value (same as compute_area_wrapper without bound)
+*/
+float compute_area_parallel(const std::vector<std::string>& currList, const std::vector<int>& operandCountVec,
+    const std::vector<int>& operatorCountVec, ModuleStore& moduleStore, bool generatePlotData, int threadCount,
+    const fixedOutline_t* outline, chipBox_t* outChipBox)
+{
+    if (threadCount <= 0)
+    {
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+    int expressionSize = (int)currList.size();
+    std::vector<areaNode_t> nodeList(expressionSize);
+
+    // Split the largest subtrees first (parents are always before their children in the list)
+    std::vector<subtreeRange_t> subtreeList(1);
+    subtreeList[0].begin = 0;
+    subtreeList[0].end = expressionSize - 1;
+    auto smallerSubtree = [&subtreeList](int index1, int index2)
+    {
+        return subtreeList[index1].end - subtreeList[index1].begin < subtreeList[index2].end - subtreeList[index2].begin;
+    };
+    std::priority_queue<int, std::vector<int>, decltype(smallerSubtree)> splitQueue(smallerSubtree);
+    splitQueue.push(0);
+    std::vector<subtreeRange_t> taskList;
+    while (!splitQueue.empty())
+    {
+        subtreeRange_t currRange = subtreeList[splitQueue.top()];
+        int currIndex = splitQueue.top();
+        splitQueue.pop();
+        bool canSplit = (int)(taskList.size() + splitQueue.size()) + 1 < threadCount * PARALLELEVALTASKSPERTHREAD &&
+            currRange.end - currRange.begin + 1 >= 2 * PARALLELEVALGRAIN + 1;
+        int child1End = currRange.end - 2;
+        if (canSplit)
+        {
+            // Left child ends at the last index where the stack is one deeper than before the room
+            int depthBefore = (currRange.begin > 0) ?
+                operandCountVec[currRange.begin - 1] - operatorCountVec[currRange.begin - 1] : 0;
+            while (child1End >= currRange.begin &&
+                operandCountVec[child1End] - operatorCountVec[child1End] != depthBefore + 1)
+            {
+                --child1End;
+            }
+            canSplit = child1End - currRange.begin + 1 >= PARALLELEVALGRAIN &&
+                currRange.end - 1 - child1End >= PARALLELEVALGRAIN;
+        }
+        if (!canSplit)
+        {
+            taskList.push_back(currRange);
+            continue;
+        }
+        subtreeRange_t child1, child2;
+        child1.begin = currRange.begin;
+        child1.end = child1End;
+        child2.begin = child1End + 1;
+        child2.end = currRange.end - 1;
+        subtreeList[currIndex].child1 = (int)subtreeList.size();
+        subtreeList.push_back(child1);
+        subtreeList[currIndex].child2 = (int)subtreeList.size();
+        subtreeList.push_back(child2);
+        splitQueue.push(subtreeList[currIndex].child1);
+        splitQueue.push(subtreeList[currIndex].child2);
+    }
+    std::sort(taskList.begin(), taskList.end(), [](const subtreeRange_t& range1, const subtreeRange_t& range2)
+        { return range1.end - range1.begin > range2.end - range2.begin; });
+
+    run_tasks(taskList, threadCount, [&currList, &moduleStore, &nodeList](const subtreeRange_t& inRange)
+        { evaluate_subtree(currList, moduleStore, nodeList, inRange); });
+
+    // Combine the split rooms bottom-up
+    for (int s = (int)subtreeList.size() - 1; s >= 0; --s)
+    {
+        const subtreeRange_t& currRange = subtreeList[s];
+        if (currRange.child1 == -1)
+        {
+            continue;
+        }
+        areaNode_t& currNode = nodeList[currRange.end];
+        currNode.child1 = subtreeList[currRange.child1].end;
+        currNode.child2 = subtreeList[currRange.child2].end;
+        const areaNode_t& module1 = nodeList[currNode.child1];
+        const areaNode_t& module2 = nodeList[currNode.child2];
+        currNode.isHorizontal = is_horizontal_partition(currList[currRange.end]);
+        if (currNode.isHorizontal)
+        {
+            currNode.width = std::max(module1.width, module2.width);
+            currNode.height = module1.height + module2.height;
+        }
+        else
+        {
+            currNode.width = module1.width + module2.width;
+            currNode.height = std::max(module1.height, module2.height);
+        }
+        currNode.moduleId = -1;
+    }
+    const areaNode_t& topRoom = nodeList[expressionSize - 1];
+    float totalArea = outline ? outline_cost(topRoom.width, topRoom.height, *outline) : topRoom.width * topRoom.height;
+    if (outChipBox)
+    {
+        outChipBox->width = topRoom.width;
+        outChipBox->height = topRoom.height;
+    }
+
+    if (generatePlotData)
+    {
+        moduleStore.clear_placement();
+        nodeList[expressionSize - 1].x = 0;
+        nodeList[expressionSize - 1].y = 0;
+        // Split rooms top-down (only their own room and the roots of their children)
+        for (auto& currRange : subtreeList)
+        {
+            if (currRange.child1 == -1)
+            {
+                continue;
+            }
+            subtreeRange_t roomRange;
+            roomRange.begin = currRange.end;
+            roomRange.end = currRange.end;
+            place_subtree(moduleStore, nodeList, roomRange);
+        }
+        run_tasks(taskList, threadCount, [&moduleStore, &nodeList](const subtreeRange_t& inRange)
+            { place_subtree(moduleStore, nodeList, inRange); });
+    }
+    return totalArea;
+}
@@ -0,0 +1,43 @@
+#ifndef __PARALLEL_EVALUATION_H__
+#define __PARALLEL_EVALUATION_H__
+
+#include <string>
+#include <vector>
+
+#include "ModuleStore.h"
+#include "FixedOutline.h"
+
+/*
+* Parallel evaluation constraints
+*/
+// Expression elements below which the area is computed serially
+#define PARALLELEVALMINSIZE 65536
+// Smallest subtree (expression elements) split off as a task
+#define PARALLELEVALGRAIN 4096
+// Tasks per thread (spread uneven subtrees over the threads)
+#define PARALLELEVALTASKSPERTHREAD 8
+
+/*
+* Function to compute the area of a hard module expression on several threads
+* @param currList -> current expression
+* @param operandCountVec -> operands up to each index (PolishExpression prefix counts)
+* @param operatorCountVec -> operators up to each index
+* @param moduleStore -> module details table (no soft or rotatable modules)
+* @param generatePlotData -> if the placement is written to the module store
+* @param threadCount -> threads to use (0 => hardware concurrency)
+* @param outline -> fixed outline (NULL => none), adds the penalty for the area outside it
+* @param outChipBox -> chip box of the root room (NULL => not needed)
+* @return float of area value (same as compute_area_wrapper without bound)
+*
+* Logic: The stack depth after index k is operands - operators up to k, so the left child of
+* the room at index e ends at the last index before e - 1 where the depth is one more than
+* before the room. The largest subtrees are split this way into up to
+* PARALLELEVALTASKSPERTHREAD tasks per thread (children of at least PARALLELEVALGRAIN
+* elements), threads take the tasks largest first, then the split rooms are combined up
+* the tree. Placement goes the other way: split rooms top-down, then the tasks in parallel.
+*/
+float compute_area_parallel(const std::vector<std::string>& currList, const std::vector<int>& operandCountVec,
+    const std::vector<int>& operatorCountVec, ModuleStore& moduleStore, bool generatePlotData, int threadCount,
+    const fixedOutline_t* outline = NULL, chipBox_t* outChipBox = NULL);
+
+#endif // !__PARALLEL_EVALUATION_H__
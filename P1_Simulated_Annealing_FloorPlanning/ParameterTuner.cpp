@@ -0,0 +1,207 @@
+
+#include <sstream>
+#include <algorithm>
+#include <mutex>
+#include <chrono>
+#include <limits>
+
+#include "ParameterTuner.h"
+#include "ThreadPool.h"
+#include "Floorplanner.h"
+
+/*
+* Grid of the search (scales apply to the base config)
+*/
+static const float tempScalingList[] = { 0.8f, 0.9f, 0.95f };
+static const float runMultiplierScaleList[] = { 0.02f, 0.05f, 0.2f };
+static const float tempMinScaleList[] = { 1.0f, 0.1f };
+static const float tempStartScaleList[] = { 1.0f, 0.1f };
+
+/*
+* Type for one parameter set and its results so far
+*/
+typedef struct tuneCandidate_t
+{
+    annealConfig_t config;
+    int runs = 0;
+    double areaSum = 0;
+    double runTimeSum = 0;
+    // Best cost over time of every run (ranked at the common time budget)
+    std::vector<std::vector<costSample_t> > curveList;
+    bool isValid = true;
+} tuneCandidate_t;
+
+/*
+* Function to read the best cost of a run at a time budget
+* @param costCurve -> best cost over time of the run
+* @param timeBudget -> seconds since the run start
+* @return best cost of the last sample within the budget (first sample if none)
+*/
+static float cost_at_budget(const std::vector<costSample_t>& costCurve, double timeBudget)
+{
+    if (costCurve.empty())
+    {
+        return std::numeric_limits<float>::max();
+    }
+    float bestCost = costCurve[0].bestCost;
+    for (auto& currSample : costCurve)
+    {
+        if (currSample.time > timeBudget)
+        {
+            break;
+        }
+        bestCost = currSample.bestCost;
+    }
+    return bestCost;
+}
+
+/*
+* Function to print a parameter set as command line options
+* @param inConfig -> parameter set
+* @return options to reuse the set
+*/
+static std::string config_options(const annealConfig_t& inConfig)
+{
+    std::ostringstream optionStream;
+    optionStream << "--temp-start " << inConfig.initialTemperature << " --temp-min " << inConfig.tempConstraint
+        << " --temp-scaling " << inConfig.tempScaling << " --run-multiplier " << inConfig.runMultiplier;
+    return optionStream.str();
+}
+
+/*
+* Function to search the annealing parameters by successive halving
+* @param moduleList -> modules of the sample design
+* @param options -> run options, config holds the base parameters (threadCount => parallel runs)
+* @param logStream -> stream for the rounds and the best parameter set
+* @return bool if the runs were valid
+*/
+bool run_tuning(const std::vector<cirModule_t>& moduleList, const runOptions_t& options, std::ostream& logStream)
+{
+    // Single anneals, one thread each
+    runOptions_t runOptions = options;
+    runOptions.tuneParameters = false;
+    runOptions.solver = "anneal";
+    runOptions.threadCount = 1;
+    runOptions.islandCount = 1;
+    runOptions.speculativeMoves = 1;
+    runOptions.lnsPolish = false;
+    runOptions.profileCounters = false;
+    runOptions.traceRecordFile.clear();
+    runOptions.paretoFile.clear();
+    runOptions.config.verbose = false;
+    unsigned int baseSeed = (options.config.seed != 0) ? options.config.seed : 1;
+
+    std::vector<tuneCandidate_t> candidateList;
+    for (float tempScaling : tempScalingList)
+    {
+        for (float runScale : runMultiplierScaleList)
+        {
+            for (float tempMinScale : tempMinScaleList)
+            {
+                for (float tempStartScale : tempStartScaleList)
+                {
+                    tuneCandidate_t currCandidate;
+                    currCandidate.config = runOptions.config;
+                    currCandidate.config.tempScaling = tempScaling;
+                    currCandidate.config.runMultiplier = std::max(1, (int)(runScale * runOptions.config.runMultiplier));
+                    currCandidate.config.tempConstraint = tempMinScale * runOptions.config.tempConstraint;
+                    currCandidate.config.initialTemperature = tempStartScale * runOptions.config.initialTemperature;
+                    // Start must stay above the lowest temperature
+                    if (currCandidate.config.initialTemperature > currCandidate.config.tempConstraint)
+                    {
+                        candidateList.push_back(currCandidate);
+                    }
+                }
+            }
+        }
+    }
+    // Equal time budget for every set: raw decrease per second would favour the shortest runs
+    double timeBudget = 0;
+    auto candidateScore = [&timeBudget](const tuneCandidate_t& inCandidate) -> double
+    {
+        if (!inCandidate.isValid || inCandidate.curveList.empty())
+        {
+            return (double)std::numeric_limits<float>::max();
+        }
+        double areaSum = 0;
+        for (auto& currCurve : inCandidate.curveList)
+        {
+            areaSum += cost_at_budget(currCurve, timeBudget);
+        }
+        return areaSum / inCandidate.curveList.size();
+    };
+
+    for (int round = 0; candidateList.size() > 1 || round == 0; ++round)
+    {
+        int seedCount = TUNESEEDS << round;
+        std::mutex resultMutex;
+        std::chrono::steady_clock::time_point roundStart = std::chrono::steady_clock::now();
+        {
+            ThreadPool workerPool(options.threadCount);
+            for (auto& currCandidate : candidateList)
+            {
+                for (int s = currCandidate.runs; s < seedCount; ++s)
+                {
+                    tuneCandidate_t* candidatePtr = &currCandidate;
+                    unsigned int runSeed = baseSeed + (unsigned int)s;
+                    workerPool.submit([candidatePtr, runSeed, &runOptions, &moduleList, &resultMutex]()
+                    {
+                        runOptions_t currOptions = runOptions;
+                        currOptions.config = candidatePtr->config;
+                        currOptions.config.seed = runSeed;
+                        std::ostringstream logStream;
+                        PolishExpression currPolishExpression;
+                        floorplanResult_t result = run_floorplan(currPolishExpression, moduleList, currOptions, logStream);
+                        std::lock_guard<std::mutex> resultLock(resultMutex);
+                        candidatePtr->isValid = candidatePtr->isValid && result.isValid;
+                        ++candidatePtr->runs;
+                        candidatePtr->areaSum += result.bestCost;
+                        candidatePtr->runTimeSum += result.runTime;
+                        candidatePtr->curveList.push_back(std::move(result.costCurve));
+                    });
+                }
+            }
+            // Pool joins the runs of the round
+        }
+        if (!candidateList[0].isValid)
+        {
+            // Same design for every run => the input itself is invalid
+            return false;
+        }
+        if (round == 0)
+        {
+            // Budget: median run time of the first round (end of the last cost sample)
+            std::vector<double> runTimeList;
+            for (auto& currCandidate : candidateList)
+            {
+                for (auto& currCurve : currCandidate.curveList)
+                {
+                    if (!currCurve.empty())
+                    {
+                        runTimeList.push_back(currCurve.back().time);
+                    }
+                }
+            }
+            if (!runTimeList.empty())
+            {
+                std::nth_element(runTimeList.begin(), runTimeList.begin() + runTimeList.size() / 2, runTimeList.end());
+                timeBudget = runTimeList[runTimeList.size() / 2];
+            }
+        }
+        std::stable_sort(candidateList.begin(), candidateList.end(), [&candidateScore](const tuneCandidate_t& candidate1,
+            const tuneCandidate_t& candidate2) { return candidateScore(candidate1) < candidateScore(candidate2); });
+        const tuneCandidate_t& bestCandidate = candidateList[0];
+        logStream << "Round " << round + 1 << ": " << candidateList.size() << " parameter sets x " << seedCount << " seeds in "
+            << std::chrono::duration<double>(std::chrono::steady_clock::now() - roundStart).count() << "s, best "
+            << config_options(bestCandidate.config) << " (area " << candidateScore(bestCandidate) << " at " << timeBudget
+            << "s, final " << bestCandidate.areaSum / bestCandidate.runs << " in " << bestCandidate.runTimeSum / bestCandidate.runs
+            << "s)\n";
+        candidateList.resize((candidateList.size() + 1) / 2);
+    }
+
+    const tuneCandidate_t& bestCandidate = candidateList[0];
+    logStream << "Best parameters (" << bestCandidate.runs << " seeds): mean area " << candidateScore(bestCandidate)
+        << " within the " << timeBudget << "s budget, final " << bestCandidate.areaSum / bestCandidate.runs << " in "
+        << bestCandidate.runTimeSum / bestCandidate.runs << "s\n" << config_options(bestCandidate.config) << "\n";
+    return true;
+}
@@ -0,0 +1,33 @@
+#ifndef __PARAMETER_TUNER_H__
+#define __PARAMETER_TUNER_H__
+
+#include <vector>
+#include <iostream>
+
+#include "RunOptions.h"
+
+/*
+* Tuning constraints
+*/
+// Seeds per parameter set in the first round (doubles every round)
+#define TUNESEEDS 2
+
+/*
+* Function to search the annealing parameters by successive halving
+* @param moduleList -> modules of the sample design
+* @param options -> run options, config holds the base parameters (threadCount => parallel runs)
+* @param logStream -> stream for the rounds and the best parameter set
+* @return bool if the runs were valid
+*
+* Logic: Parameter sets are a grid around the base config (temperature scaling,
+* start and lowest temperature, run multiplier cut down to short runs). Every
+* round anneals each remaining set with TUNESEEDS << round seeds (results of earlier
+* rounds are kept) on a ThreadPool, ranks the sets by mean best area reached within
+* the same time budget (median run time of the first round, read from the cost curve
+* of every run: shorter runs keep their final area, longer ones are cut at the budget)
+* and keeps the better half, until one set is left. The time out stays the base one
+* (cap of every run).
+*/
+bool run_tuning(const std::vector<cirModule_t>& moduleList, const runOptions_t& options, std::ostream& logStream);
+
+#endif // !__PARAMETER_TUNER_H__
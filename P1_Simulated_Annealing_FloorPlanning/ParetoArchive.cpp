@@ -0,0 +1,173 @@
+
+#include <iostream>
+#include <fstream>
+#include <limits>
+#include <cmath>
+#include <numeric>
+
+#include "ParetoArchive.h"
+
+/*
+* Constructor
+* @param inNetlist -> nets for the wirelength (NULL or empty => no wirelength)
+* @param inCapacity -> maximum number of entries
+*/
+ParetoArchive::ParetoArchive(const Netlist* inNetlist, int inCapacity)
+{
+    this->netlist = (inNetlist && !inNetlist->empty()) ? inNetlist : NULL;
+    this->capacity = std::max(1, inCapacity);
+    this->offerCount = 0;
+    this->insertCount = 0;
+}
+
+/*
+* Function to check if a point is dominated by (or equal to) an archive entry
+* @param inObjectives -> point to check
+* @return bool if some entry is at least as good in every objective
+*/
+bool ParetoArchive::is_dominated(const objectives_t& inObjectives) const
+{
+    for (int i = 0; i < this->size(); ++i)
+    {
+        if (this->areaVec[i] <= inObjectives.area && this->aspectVec[i] <= inObjectives.aspect &&
+            this->wirelengthVec[i] <= inObjectives.wirelength)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+/*
+* Function to remove an entry
+* @param index -> entry to remove
+*
+* NOTE: Order does not matter => last entry moves into the slot
+*/
+void ParetoArchive::remove_entry(int index)
+{
+    int last = this->size() - 1;
+    this->areaVec[index] = this->areaVec[last];
+    this->aspectVec[index] = this->aspectVec[last];
+    this->wirelengthVec[index] = this->wirelengthVec[last];
+    this->expressionList[index].swap(this->expressionList[last]);
+    this->areaVec.pop_back();
+    this->aspectVec.pop_back();
+    this->wirelengthVec.pop_back();
+    this->expressionList.pop_back();
+}
+
+/*
+* Function to drop the most crowded entry (archive over capacity)
+*
+* Logic: Objectives are scaled by the archive range, the entry with the smallest
+* distance (sum of the scaled differences) to its nearest neighbour is dropped
+*/
+void ParetoArchive::remove_crowded_entry()
+{
+    const std::vector<float>* columnList[3] = { &this->areaVec, &this->aspectVec, &this->wirelengthVec };
+    float columnScale[3];
+    std::vector<bool> isExtreme(this->size(), false);
+    for (int c = 0; c < 3; ++c)
+    {
+        const std::vector<float>& column = *columnList[c];
+        auto minMax = std::minmax_element(column.begin(), column.end());
+        columnScale[c] = (*minMax.second > *minMax.first) ? 1 / (*minMax.second - *minMax.first) : 0;
+        // Constant column (wirelength without netlist) has no best entry to keep
+        if (columnScale[c] > 0)
+        {
+            isExtreme[minMax.first - column.begin()] = true;
+        }
+    }
+    int crowdedIndex = -1;
+    float crowdedDistance = std::numeric_limits<float>::infinity();
+    for (int i = 0; i < this->size(); ++i)
+    {
+        if (isExtreme[i])
+        {
+            continue;
+        }
+        float nearestDistance = std::numeric_limits<float>::infinity();
+        for (int j = 0; j < this->size(); ++j)
+        {
+            if (j == i)
+            {
+                continue;
+            }
+            float distance = 0;
+            for (int c = 0; c < 3; ++c)
+            {
+                distance += std::abs((*columnList[c])[i] - (*columnList[c])[j]) * columnScale[c];
+            }
+            nearestDistance = std::min(nearestDistance, distance);
+        }
+        if (nearestDistance < crowdedDistance)
+        {
+            crowdedDistance = nearestDistance;
+            crowdedIndex = i;
+        }
+    }
+    this->remove_entry((crowdedIndex >= 0) ? crowdedIndex : this->size() - 1);
+}
+
+/*
+* Function to add a point if no entry dominates it (removes the entries it dominates)
+* @param inObjectives -> objectives of the floorplan
+* @param inExpression -> polish expression of the floorplan
+* @return bool if the point entered the archive
+*/
+bool ParetoArchive::insert(const objectives_t& inObjectives, const std::vector<std::string>& inExpression)
+{
+    if (this->is_dominated(inObjectives))
+    {
+        return false;
+    }
+    for (int i = this->size() - 1; i >= 0; --i)
+    {
+        if (inObjectives.area <= this->areaVec[i] && inObjectives.aspect <= this->aspectVec[i] &&
+            inObjectives.wirelength <= this->wirelengthVec[i])
+        {
+            this->remove_entry(i);
+        }
+    }
+    this->areaVec.push_back(inObjectives.area);
+    this->aspectVec.push_back(inObjectives.aspect);
+    this->wirelengthVec.push_back(inObjectives.wirelength);
+    this->expressionList.push_back(inExpression);
+    ++this->insertCount;
+    if (this->size() > this->capacity)
+    {
+        this->remove_crowded_entry();
+    }
+    return true;
+}
+
+/*
+* Function to write the archive sorted by area
+* @param outputFile -> file to write
+* @return bool if the file could be written
+*/
+bool ParetoArchive::write_archive_file(const std::string& outputFile) const
+{
+    std::ofstream OUTFH(outputFile);
+    if (!OUTFH.is_open())
+    {
+        std::cerr << "Unable to open the Pareto archive file: " << outputFile << "\n";
+        return false;
+    }
+    std::vector<int> order(this->size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [this](int index1, int index2)
+        { return this->areaVec[index1] < this->areaVec[index2]; });
+    OUTFH << "Area\tAspect\tWirelength\tExpression\n";
+    for (int i : order)
+    {
+        OUTFH << this->areaVec[i] << "\t" << this->aspectVec[i] << "\t" << this->wirelengthVec[i] << "\t";
+        for (auto& element : this->expressionList[i])
+        {
+            OUTFH << element << " ";
+        }
+        OUTFH << "\n";
+    }
+    return true;
+}
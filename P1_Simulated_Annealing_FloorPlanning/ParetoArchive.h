@@ -0,0 +1,141 @@
+#ifndef __PARETO_ARCHIVE_H__
+#define __PARETO_ARCHIVE_H__
+
+#include <string>
+#include <vector>
+#include <algorithm>
+
+#include "Netlist.h"
+#include "FixedOutline.h"
+
+/*
+* Pareto archive constraints
+*/
+// Maximum number of non-dominated expressions kept
+#define PARETOARCHIVESIZE 64
+
+/*
+* Type for the objectives of one floorplan (all minimized)
+*/
+typedef struct objectives_t
+{
+    // Chip width * height
+    float area = 0;
+    // max(width / height, height / width) => 1 for a square chip
+    float aspect = 0;
+    // Half perimeter wirelength (0 without netlist)
+    float wirelength = 0;
+} objectives_t;
+
+/*
+* Bounded archive of non-dominated floorplans seen during a run
+*
+* Objectives are kept per column (area, aspect, wirelength) so the dominance
+* check of a new point is a scan over three small float arrays, and the
+* expression is only copied once the point is known to enter the archive.
+* When full, the entry closest to its nearest neighbour (objectives normalized by
+* the archive range) is dropped; the best entry of each objective is always kept.
+*/
+class ParetoArchive
+{
+private:
+    std::vector<float> areaVec;
+    std::vector<float> aspectVec;
+    std::vector<float> wirelengthVec;
+    std::vector<std::vector<std::string> > expressionList;
+    // Nets for the wirelength (NULL => area and aspect only)
+    const Netlist* netlist;
+    int capacity;
+    // Points offered / entered the archive
+    long long offerCount;
+    long long insertCount;
+
+    /*
+    * Function to check if a point is dominated by (or equal to) an archive entry
+    * @param inObjectives -> point to check
+    * @return bool if some entry is at least as good in every objective
+    */
+    bool is_dominated(const objectives_t& inObjectives) const;
+
+    /*
+    * Function to remove an entry
+    * @param index -> entry to remove
+    */
+    void remove_entry(int index);
+
+    /*
+    * Function to drop the most crowded entry (archive over capacity)
+    */
+    void remove_crowded_entry();
+
+public:
+
+    /*
+    * Constructor
+    * @param inNetlist -> nets for the wirelength (NULL or empty => no wirelength)
+    * @param inCapacity -> maximum number of entries
+    */
+    explicit ParetoArchive(const Netlist* inNetlist, int inCapacity = PARETOARCHIVESIZE);
+
+    /*
+    * Function to add a point if no entry dominates it (removes the entries it dominates)
+    * @param inObjectives -> objectives of the floorplan
+    * @param inExpression -> polish expression of the floorplan
+    * @return bool if the point entered the archive
+    */
+    bool insert(const objectives_t& inObjectives, const std::vector<std::string>& inExpression);
+
+    /*
+    * Function to offer an evaluated floorplan to the archive
+    * @param inState -> floorplan, cost just evaluated
+    * @return bool if the floorplan entered the archive
+    *
+    * NOTE: Area and aspect come from the chip box of the cost evaluation, no second
+    * pass. The wirelength needs the module centers, which the bottom-up cost pass
+    * does not compute => with a netlist every offer runs a second full pass (placement)
+    */
+    template <typename Representation>
+    bool offer(Representation& inState)
+    {
+        ++this->offerCount;
+        chipBox_t chipBox;
+        if (!inState.get_last_chip_box(chipBox))
+        {
+            inState.compute_chip_size(chipBox.width, chipBox.height);
+        }
+        else if (this->netlist)
+        {
+            inState.compute_area(true);
+        }
+        objectives_t currObjectives;
+        currObjectives.area = chipBox.width * chipBox.height;
+        currObjectives.aspect = std::max(chipBox.width / chipBox.height, chipBox.height / chipBox.width);
+        if (this->netlist)
+        {
+            currObjectives.wirelength = (float)this->netlist->half_perimeter_wirelength(inState.get_module_store());
+        }
+        if (this->is_dominated(currObjectives))
+        {
+            return false;
+        }
+        return this->insert(currObjectives, inState.get_polish_expression());
+    }
+
+    /*
+    * Getters for the archive
+    */
+    int size() const { return (int)this->expressionList.size(); }
+    long long get_offer_count() const { return this->offerCount; }
+    long long get_insert_count() const { return this->insertCount; }
+
+    /*
+    * Function to write the archive sorted by area
+    * @param outputFile -> file to write
+    * @return bool if the file could be written
+    *
+    * Format: one floorplan per line: <area> <aspect_ratio> <wirelength> <polish expression>
+    */
+    bool write_archive_file(const std::string& outputFile) const;
+};
+
+#endif // !__PARETO_ARCHIVE_H__
@@ -0,0 +1,256 @@
+
+#include <cstring>
+#include <cerrno>
+#include <iomanip>
+#include <sstream>
+#include <algorithm>
+
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include "PerfProfiler.h"
+
+/*
+* Counter names and perf event configuration (same order as PERF_*)
+*/
+static const char* counterNames[PERFCOUNTERCOUNT] = { "cycles", "instructions", "L1d-miss", "LLC-miss", "br-miss" };
+static const char* phaseNames[PHASECOUNT] = { "move", "eval", "rollback" };
+
+static void get_counter_config(int counter, __u32& outType, __u64& outConfig)
+{
+    outType = PERF_TYPE_HARDWARE;
+    switch (counter)
+    {
+    case PERF_CYCLES:
+        outConfig = PERF_COUNT_HW_CPU_CYCLES;
+        break;
+    case PERF_INSTRUCTIONS:
+        outConfig = PERF_COUNT_HW_INSTRUCTIONS;
+        break;
+    case PERF_L1D_MISSES:
+        outType = PERF_TYPE_HW_CACHE;
+        outConfig = PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+        break;
+    case PERF_LLC_MISSES:
+        outConfig = PERF_COUNT_HW_CACHE_MISSES;
+        break;
+    default:
+        outConfig = PERF_COUNT_HW_BRANCH_MISSES;
+        break;
+    }
+}
+
+/*
+* Constructor: opens the counters on the calling thread
+* @param moveTypeCount -> number of move types to keep totals for
+* @param inReportStream -> stream for the step and final reports
+*/
+PerfProfiler::PerfProfiler(int moveTypeCount, std::ostream& inReportStream)
+    : moveTypeTotals(moveTypeCount * PHASECOUNT), reportStream(inReportStream)
+{
+    this->leaderFd = -1;
+    this->timeEnabled = 0;
+    this->timeRunning = 0;
+    std::memset(this->phaseStart, 0, sizeof(this->phaseStart));
+    for (int counter = 0; counter < PERFCOUNTERCOUNT; ++counter)
+    {
+        this->counterFdList[counter] = -1;
+        struct perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        get_counter_config(counter, attr.type, attr.config);
+        // Enabled/running times reveal multiplexing (group is scheduled as a whole)
+        attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+        // User space of this thread only (works with perf_event_paranoid <= 2)
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.disabled = (this->leaderFd == -1) ? 1 : 0;
+        int fd = (int)syscall(SYS_perf_event_open, &attr, 0, -1, this->leaderFd, 0);
+        if (fd < 0)
+        {
+            if (this->unavailableReason.empty())
+            {
+                this->unavailableReason = std::string(counterNames[counter]) + ": " + std::strerror(errno);
+            }
+            continue;
+        }
+        if (this->leaderFd == -1)
+        {
+            this->leaderFd = fd;
+        }
+        this->counterFdList[counter] = fd;
+        this->readOrder.push_back(counter);
+    }
+    if (this->leaderFd != -1)
+    {
+        ioctl(this->leaderFd, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+        ioctl(this->leaderFd, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    }
+}
+
+PerfProfiler::~PerfProfiler()
+{
+    for (int counter = 0; counter < PERFCOUNTERCOUNT; ++counter)
+    {
+        if (this->counterFdList[counter] != -1)
+        {
+            close(this->counterFdList[counter]);
+        }
+    }
+}
+
+/*
+* Function to read the current counter values
+* @param outValues -> values per counter (0 for counters not opened), scaled if multiplexed
+* @return bool if the read succeeded
+*/
+bool PerfProfiler::read_counters(uint64_t outValues[PERFCOUNTERCOUNT])
+{
+    // Group read format: number of values, time enabled, time running, then the values
+    uint64_t readBuffer[PERFCOUNTERCOUNT + 3];
+    if (read(this->leaderFd, readBuffer, sizeof(readBuffer)) <= 0)
+    {
+        return false;
+    }
+    this->timeEnabled = readBuffer[1];
+    this->timeRunning = readBuffer[2];
+    // Not scheduled yet => no estimate
+    double scale = (this->timeRunning > 0) ? (double)this->timeEnabled / this->timeRunning : 0;
+    std::memset(outValues, 0, PERFCOUNTERCOUNT * sizeof(uint64_t));
+    for (size_t i = 0; i < this->readOrder.size() && i < readBuffer[0]; ++i)
+    {
+        outValues[this->readOrder[i]] = (this->timeRunning == this->timeEnabled) ? readBuffer[i + 3] :
+            (uint64_t)(readBuffer[i + 3] * scale);
+    }
+    return true;
+}
+
+/*
+* Function to print the multiplexing note of a report (nothing if the group always ran)
+*/
+void PerfProfiler::print_multiplex_note()
+{
+    if (this->timeRunning < this->timeEnabled)
+    {
+        // Formatted locally, the precision would otherwise stay on the report stream (std::cout)
+        std::ostringstream shareStream;
+        shareStream << std::fixed << std::setprecision(1) << 100.0 * this->timeRunning / std::max<uint64_t>(this->timeEnabled, 1);
+        this->reportStream << "  NOTE: counters multiplexed (on the PMU " << shareStream.str()
+            << "% of the time), values are scaled estimates\n";
+    }
+}
+
+/*
+* Function to mark the start of a phase
+*/
+void PerfProfiler::begin_phase()
+{
+    this->read_counters(this->phaseStart);
+}
+
+/*
+* Function to mark the end of a phase
+* @param moveType -> move type (1..moveTypeCount)
+* @param phase -> PHASE_MOVE, PHASE_EVAL or PHASE_ROLLBACK
+*/
+void PerfProfiler::end_phase(int moveType, int phase)
+{
+    uint64_t phaseEnd[PERFCOUNTERCOUNT];
+    if (!this->read_counters(phaseEnd))
+    {
+        return;
+    }
+    perfSample_t& moveSample = this->moveTypeTotals[(moveType - 1) * PHASECOUNT + phase];
+    perfSample_t& stepSample = this->stepTotals[phase];
+    for (int counter = 0; counter < PERFCOUNTERCOUNT; ++counter)
+    {
+        // Scaled estimates can step back when the scale changes
+        uint64_t delta = (phaseEnd[counter] > this->phaseStart[counter]) ? phaseEnd[counter] - this->phaseStart[counter] : 0;
+        moveSample.values[counter] += delta;
+        stepSample.values[counter] += delta;
+    }
+    ++moveSample.count;
+    ++stepSample.count;
+}
+
+/*
+* Function to print one bucket as per phase averages
+* @param outStream -> stream to print to
+* @param label -> bucket label
+* @param inSample -> accumulated values
+* @param counterFdList -> opened counters (-1 => n/a)
+*/
+static void print_sample(std::ostream& outStream, const std::string& label, const perfSample_t& inSample,
+    const int counterFdList[PERFCOUNTERCOUNT])
+{
+    // Line formatted locally, fixed/precision must not stay on outStream (std::cout)
+    std::ostringstream lineStream;
+    lineStream << "  " << std::left << std::setw(12) << label << std::right << std::setw(10) << inSample.count;
+    for (int counter = 0; counter < PERFCOUNTERCOUNT; ++counter)
+    {
+        lineStream << std::setw(14);
+        if (counterFdList[counter] == -1 || inSample.count == 0)
+        {
+            lineStream << "n/a";
+        }
+        else
+        {
+            lineStream << std::fixed << std::setprecision(2) << (double)inSample.values[counter] / inSample.count;
+        }
+    }
+    if (counterFdList[PERF_CYCLES] != -1 && counterFdList[PERF_INSTRUCTIONS] != -1 && inSample.values[PERF_CYCLES] > 0)
+    {
+        lineStream << std::setw(8) << std::setprecision(2) << (double)inSample.values[PERF_INSTRUCTIONS] / inSample.values[PERF_CYCLES];
+    }
+    outStream << lineStream.str() << "\n";
+}
+
+/*
+* Function to print the table header
+*/
+static void print_header(std::ostream& outStream)
+{
+    outStream << "  " << std::left << std::setw(12) << "phase" << std::right << std::setw(10) << "count";
+    for (int counter = 0; counter < PERFCOUNTERCOUNT; ++counter)
+    {
+        outStream << std::setw(14) << counterNames[counter];
+    }
+    outStream << std::setw(8) << "IPC" << "\n";
+}
+
+/*
+* Function to report and reset the totals of a temperature step
+* @param step -> temperature step number
+*/
+void PerfProfiler::end_step(int step)
+{
+    this->reportStream << "Counters per phase (average) for step #" << step << ":\n";
+    print_header(this->reportStream);
+    for (int phase = 0; phase < PHASECOUNT; ++phase)
+    {
+        print_sample(this->reportStream, phaseNames[phase], this->stepTotals[phase], this->counterFdList);
+        this->stepTotals[phase] = perfSample_t();
+    }
+    this->print_multiplex_note();
+}
+
+/*
+* Function to report the totals per move type and phase
+*/
+void PerfProfiler::print_report()
+{
+    this->reportStream << "Counters per move type and phase (average):\n";
+    print_header(this->reportStream);
+    int moveTypeCount = (int)this->moveTypeTotals.size() / PHASECOUNT;
+    for (int moveType = 1; moveType <= moveTypeCount; ++moveType)
+    {
+        for (int phase = 0; phase < PHASECOUNT; ++phase)
+        {
+            print_sample(this->reportStream, "M" + std::to_string(moveType) + " " + phaseNames[phase],
+                this->moveTypeTotals[(moveType - 1) * PHASECOUNT + phase], this->counterFdList);
+        }
+    }
+    this->print_multiplex_note();
+}
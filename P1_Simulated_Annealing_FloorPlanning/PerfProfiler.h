@@ -0,0 +1,130 @@
+#ifndef __PERF_PROFILER_H__
+#define __PERF_PROFILER_H__
+
+#include <vector>
+#include <string>
+#include <ostream>
+#include <cstdint>
+
+/*
+* Hardware counters read by the profiler
+*/
+#define PERF_CYCLES 0
+#define PERF_INSTRUCTIONS 1
+#define PERF_L1D_MISSES 2
+#define PERF_LLC_MISSES 3
+#define PERF_BRANCH_MISSES 4
+#define PERFCOUNTERCOUNT 5
+
+/*
+* Annealing phases measured per move
+*/
+// save_state + apply_move
+#define PHASE_MOVE 0
+// cost evaluation
+#define PHASE_EVAL 1
+// restore_state of a rejected move
+#define PHASE_ROLLBACK 2
+#define PHASECOUNT 3
+
+/*
+* Type for accumulated counter values of one bucket
+*/
+typedef struct perfSample_t
+{
+    uint64_t values[PERFCOUNTERCOUNT] = {};
+    // Number of phases measured
+    long long count = 0;
+} perfSample_t;
+
+/*
+* Hardware performance counter profiler (Linux perf_event_open)
+*
+* All available counters are opened as one group on the calling thread
+* (user space only) and read with one read() per phase boundary.
+* When the kernel multiplexes the group with other events, the counts are
+* scaled by enabled / running time and the reports are marked as estimates.
+* Counters the kernel or the CPU does not support are reported as n/a,
+* if none can be opened the profiler is unavailable and the annealer runs
+* without it.
+*/
+class PerfProfiler
+{
+private:
+    // Group leader and member file descriptors (-1 if not opened)
+    int counterFdList[PERFCOUNTERCOUNT];
+    int leaderFd;
+    // Position of each opened counter in the group read
+    std::vector<int> readOrder;
+    std::string unavailableReason;
+    // Counter values at begin_phase
+    uint64_t phaseStart[PERFCOUNTERCOUNT];
+    // Group time enabled / on the PMU at the last read (ns)
+    uint64_t timeEnabled;
+    uint64_t timeRunning;
+    // Totals per move type and phase (index 0 is move type 1), and per temperature step
+    std::vector<perfSample_t> moveTypeTotals;
+    perfSample_t stepTotals[PHASECOUNT];
+    std::ostream& reportStream;
+
+    /*
+    * Function to read the current counter values
+    * @param outValues -> values per counter (0 for counters not opened), scaled if multiplexed
+    * @return bool if the read succeeded
+    */
+    bool read_counters(uint64_t outValues[PERFCOUNTERCOUNT]);
+
+    /*
+    * Function to print the multiplexing note of a report (nothing if the group always ran)
+    */
+    void print_multiplex_note();
+
+public:
+
+    /*
+    * Constructor: opens the counters on the calling thread
+    * @param moveTypeCount -> number of move types to keep totals for
+    * @param inReportStream -> stream for the step and final reports
+    */
+    PerfProfiler(int moveTypeCount, std::ostream& inReportStream);
+
+    ~PerfProfiler();
+
+    PerfProfiler(const PerfProfiler&) = delete;
+    PerfProfiler& operator=(const PerfProfiler&) = delete;
+
+    /*
+    * Getter for the counter availability
+    */
+    bool is_available() const { return this->leaderFd != -1; }
+
+    /*
+    * Getter for the reason the counters are not available
+    */
+    const std::string& get_unavailable_reason() const { return this->unavailableReason; }
+
+    /*
+    * Function to mark the start of a phase
+    */
+    void begin_phase();
+
+    /*
+    * Function to mark the end of a phase
+    * @param moveType -> move type (1..moveTypeCount)
+    * @param phase -> PHASE_MOVE, PHASE_EVAL or PHASE_ROLLBACK
+    */
+    void end_phase(int moveType, int phase);
+
+    /*
+    * Function to report and reset the totals of a temperature step
+    * @param step -> temperature step number
+    */
+    void end_step(int step);
+
+    /*
+    * Function to report the totals per move type and phase
+    */
+    void print_report();
+};
+
+#endif // !__PERF_PROFILER_H__
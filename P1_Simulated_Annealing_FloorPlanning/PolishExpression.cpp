@@ -1,28 +1,35 @@
 
 #include <iostream>
 #include <random>
-#include <stack>
 #include <fstream>
+#include <cstdlib>
 
 #include "PolishExpression.h"
 #include "HelperFuncs.h"
-
-// Create random number generator
-std::random_device rd;
-std::default_random_engine randGenerator{ rd() };
-// Range of distribution is 0->9 as grid positions are 2 columns * 5 rows = 10
-std::uniform_int_distribution<int> randDistribution(0, 100);
+#include "ShapeCurve.h"
+#include "ParallelEvaluation.h"
 
 /*
 * Base constructor
 */
-PolishExpression::PolishExpression() {}
+PolishExpression::PolishExpression()
+{
+    // Moves on the whole expression
+    this->moveWindowBegin = 0;
+    this->moveWindowEnd = -1;
+    this->lastMoveIndex1 = -1;
+    this->lastMoveIndex2 = -1;
+    this->evalThreadCount = 1;
+    this->isChipBoxValid = false;
+    std::random_device rd;
+    this->randGenerator.seed(rd());
+}
 
 /*
 * Constructor to create the vector of required size
 * @param size -> number of modules in floorplan
 */
-PolishExpression::PolishExpression(int size)
+PolishExpression::PolishExpression(int size) : PolishExpression()
 {
     // Logic for n modules, there will be n-1 partitions
     this->currExp.reserve(2 * size - 1);
@@ -31,16 +38,139 @@ PolishExpression::PolishExpression(int size)
 }
 
 /*
-* Function to clear the module placement data
+* Function to seed the random number generator of the moves
+* @param seed -> seed value
 */
-void PolishExpression::clear_module_placement()
+void PolishExpression::set_seed(unsigned int seed)
+{
+    this->randGenerator.seed(seed);
+}
+
+/*
+* Function to restrict the moves to a range of the expression
+* @param begin -> first index moves can touch
+* @param end -> index after the last index moves can touch (-1 => end of expression)
+*/
+void PolishExpression::set_move_window(int begin, int end)
+{
+    this->moveWindowBegin = begin;
+    this->moveWindowEnd = end;
+}
+
+/*
+* Function to get the number of operands moves can touch
+* @return operand count in the move window
+*/
+int PolishExpression::get_move_module_count()
+{
+    if (this->currExp.empty())
+    {
+        return this->moduleStore.size();
+    }
+    int end = this->window_end();
+    int beforeWindow = (this->moveWindowBegin > 0) ? this->operandCountVec[this->moveWindowBegin - 1] : 0;
+    return this->operandCountVec[end - 1] - beforeWindow;
+}
+
+/*
+* Function to save the current polish expression
+* @param outState -> state to copy into (capacity is reused)
+*/
+void PolishExpression::save_state(state_t& outState) const
+{
+    outState = this->currExp;
+}
+
+/*
+* Function to restore a saved polish expression
+* @param inState -> state saved by save_state
+*/
+void PolishExpression::restore_state(const state_t& inState)
+{
+    this->isChipBoxValid = false;
+    this->currExp = inState;
+    this->operandCountVec.resize(0);
+    this->operatorCountVec.resize(0);
+    this->update_op_vector();
+}
+
+/*
+* Function to perform a move by type
+* @param moveType -> 1: M1, 2: M2, 3: M3
+* @return bool -> if move successful
+*/
+bool PolishExpression::apply_move(int moveType)
 {
-    for (auto x : this->moduleList)
+    this->isChipBoxValid = false;
+    switch (moveType)
     {
-        this->moduleList[x.first].placement = std::make_pair(0, 0);
+    case 1:
+        return this->moveM1();
+    case 2:
+        return this->moveM2();
+    case 3:
+        return this->moveM3();
+    default:
+        return false;
     }
 }
 
+/*
+* Function to perform a move at given indices (no random draws)
+* @param moveType -> 1: M1, 2: M2, 3: M3
+* @param index1 -> first index as given by get_last_move
+* @param index2 -> second index as given by get_last_move
+* @return bool -> if move successful (expression unchanged otherwise)
+*/
+bool PolishExpression::apply_recorded_move(int moveType, int index1, int index2)
+{
+    this->isChipBoxValid = false;
+    int expressionSize = (int)this->currExp.size();
+    if (index1 < 0 || index1 >= expressionSize || (moveType != 2 && (index2 < 0 || index2 >= expressionSize)))
+    {
+        return false;
+    }
+    switch (moveType)
+    {
+    case 1:
+        if (is_operator(this->currExp[index1]) || is_operator(this->currExp[index2]))
+        {
+            return false;
+        }
+        this->op_swap(index1, index2, false);
+        return true;
+    case 2:
+        if (!is_operator(this->currExp[index1]))
+        {
+            return false;
+        }
+        this->invert_chain(index1);
+        return true;
+    case 3:
+        if (std::abs(index1 - index2) != 1 || is_operator(this->currExp[index1]) || !is_operator(this->currExp[index2]))
+        {
+            return false;
+        }
+        if (this->op_swap(index1, index2, true) == false)
+        {
+            // revert back as swap not possible
+            this->op_swap(index2, index1, true);
+            return false;
+        }
+        return true;
+    default:
+        return false;
+    }
+}
+
+/*
+* Function to clear the module placement data
+*/
+void PolishExpression::clear_module_placement()
+{
+    this->moduleStore.clear_placement();
+}
+
 /*
 * Getter for polish expression held
 * @return polish expression held
@@ -57,6 +187,7 @@ std::vector<std::string> PolishExpression::get_polish_expression()
 */
 void PolishExpression::create_random_expression()
 {
+    this->isChipBoxValid = false;
     // Logic for n modules, there will be n-1 partitions
     this->currExp.reserve(0);
     this->operandCountVec.reserve(0);
@@ -65,10 +196,10 @@ void PolishExpression::create_random_expression()
     int modulesAdded = 0;
     // Flag to add the first partition after adding 2 modules, then 1 partition after each module
     bool firstPartitionAdded = false;
-    for (auto currModule : this->moduleList)
+    for (int id = 0; id < this->moduleStore.size(); ++id)
     {
         // Add the operand
-        this->currExp.push_back(currModule.first);
+        this->currExp.push_back(this->moduleStore.name(id));
         ++modulesAdded;
         if (firstPartitionAdded == false && modulesAdded == 2)
         {
@@ -91,6 +222,7 @@ void PolishExpression::create_random_expression()
 */
 void PolishExpression::update_expression(std::vector<std::string> inExpression)
 {
+    this->isChipBoxValid = false;
     this->currExp.clear();
     this->currExp.resize(0);
     this->operandCountVec.resize(0);
@@ -129,7 +261,9 @@ void PolishExpression::update_op_vector()
 */
 void PolishExpression::add_module(std::string inName, cirModule_t inModule)
 {
-    this->moduleList[inName] = inModule;
+    this->isChipBoxValid = false;
+    int id = this->moduleStore.add_module(inName, inModule.area, inModule.aspectRatio, inModule.width, inModule.height);
+    this->moduleStore.set_shape_bounds(id, inModule.minAspectRatio, inModule.maxAspectRatio, inModule.isRotatable);
 }
 
 /*
@@ -143,6 +277,23 @@ bool PolishExpression::check_balloting_property(int index)
     return this->operandCountVec[index] > this->operatorCountVec[index];
 }
 
+/*
+* Function to verify balloting property from the move window begin
+* @param index -> index in the move window to check balloting at
+*
+* Logic: #operands > #operators counted from moveWindowBegin
+*/
+bool PolishExpression::check_window_balloting_property(int index)
+{
+    if (this->moveWindowBegin == 0)
+    {
+        return this->check_balloting_property(index);
+    }
+    int operandsBefore = this->operandCountVec[this->moveWindowBegin - 1];
+    int operatorsBefore = this->operatorCountVec[this->moveWindowBegin - 1];
+    return (this->operandCountVec[index] - operandsBefore) > (this->operatorCountVec[index] - operatorsBefore);
+}
+
 /*
 * Function to swap elements and update count vec
 * @param operandIndex -> index of operand
@@ -188,139 +339,151 @@ bool PolishExpression::op_swap(int operandIndex, int operatorIndex, bool updateC
 /*
 * Function to compute the area through the tree (post-ordered)
 * @param currList: current expression
-* @param moduleList: module details map
+* @param moduleStore: module details table
 * @param generatePlotData: flag to indicate whether to generate plotting relevant data
-* @return data struct of width, height, name (if return from leaf node)
-* 
-* NOTE: name will be used to create placement data for graph
+* @param costBound: stop once the area is proven above this value (no plot data)
+* @param outline: fixed outline (NULL => none), adds the penalty for the area outside it
+* @return float of area value, or a lower bound above costBound on early exit
 * 
 * Logic: Using stack based approach to ensure that logic follow bottom left to top right logic
 * which requires iterating from left to right.
 * Recursion based approach goes from right to left -> reverse => placement computation will be complicated
+* 
+* NOTE: Each element of the expression is one node of the tree (same index), stack holds node indices
+* In post-order the parent always comes after its children, so placement can be pushed down
+* by walking the nodes from the root (last index) to the first
+* 
+* NOTE: Early exit bound: every room on the stack ends up disjoint inside the chip and the
+* chip is at least as wide and tall as any room, so the area is at least
+* max(sum of stack room areas + area of modules not yet seen, max width * max height)
+* With an outline the penalty of a max width * max height box is added: a room
+* wider or taller than the outline already proves the violation
+*
+* NOTE: If any module is soft or rotatable, the area is computed through
+* shape curves (compute_shape_area_wrapper) instead, without early exit
 */
 float compute_area_wrapper(std::vector<std::string>& currList,
-    std::unordered_map<std::string, cirModule_t>& moduleList, bool generatePlotData)
+    ModuleStore& moduleStore, bool generatePlotData, float costBound, const fixedOutline_t* outline,
+    chipBox_t* outChipBox)
 {
-    int roomCount = 1;
-    std::string roomName = "room";
-    std::unordered_map<std::string, cirModule_t> room_map;
-    std::stack<cirModule_t> moduleStack;
+    if (moduleStore.has_flexible_modules())
+    {
+        return compute_shape_area_wrapper(currList, moduleStore, generatePlotData, outline, outChipBox);
+    }
+    std::vector<areaNode_t> nodeList(currList.size());
+    std::vector<int> nodeStack;
+    nodeStack.reserve(currList.size());
+    // Running lower bound data (only used below costBound)
+    bool checkBound = !generatePlotData && costBound < std::numeric_limits<float>::infinity();
+    double stackArea = 0, remainingArea = moduleStore.total_area();
+    float maxWidth = 0, maxHeight = 0;
     int index = 0;
     while (index < currList.size())
     {
-        std::string currElement = currList[index];
+        const std::string& currElement = currList[index];
+        areaNode_t& currNode = nodeList[index];
         if (is_operator(currElement))
         {
             // element is operator
             // Pop two elements
-            cirModule_t module2 = moduleStack.top();
-            moduleStack.pop();
-            cirModule_t module1 = moduleStack.top();
-            moduleStack.pop();
-            // Create room module type to insert
-            cirModule_t roomModule;
+            currNode.child2 = nodeStack.back();
+            nodeStack.pop_back();
+            currNode.child1 = nodeStack.back();
+            nodeStack.pop_back();
+            const areaNode_t& module1 = nodeList[currNode.child1];
+            const areaNode_t& module2 = nodeList[currNode.child2];
 
             if (is_vertical_partition(currElement))
             {
                 // partition type is V
-                roomModule.width = module1.width + module2.width;
-                roomModule.height = std::max(module1.height, module2.height);
+                currNode.width = module1.width + module2.width;
+                currNode.height = std::max(module1.height, module2.height);
+                currNode.isHorizontal = false;
             }
             else // H_t
             {
                 // partition type is H
-                roomModule.width = std::max(module1.width, module2.width);
-                roomModule.height = module1.height + module2.height;
+                currNode.width = std::max(module1.width, module2.width);
+                currNode.height = module1.height + module2.height;
+                currNode.isHorizontal = true;
+            }
+            currNode.moduleId = -1;
+            if (checkBound)
+            {
+                stackArea += (double)currNode.width * currNode.height -
+                    (double)module1.width * module1.height - (double)module2.width * module2.height;
+                maxWidth = std::max(maxWidth, currNode.width);
+                maxHeight = std::max(maxHeight, currNode.height);
+                float lowerBound = std::max((float)(stackArea + remainingArea), maxWidth * maxHeight);
+                if (outline)
+                {
+                    lowerBound += outline_cost(maxWidth, maxHeight, *outline) - maxWidth * maxHeight;
+                }
+                if (lowerBound > costBound)
+                {
+                    return lowerBound;
+                }
             }
-            
-            roomModule.isModule = false;
-            roomModule.name = roomName + std::to_string(roomCount);
-            // Add the inner module data
-            roomModule.module1 = module1.name;
-            roomModule.isModule1mod = module1.isModule;
-            roomModule.module2 = module2.name;
-            roomModule.isModule2mod = module2.isModule;
-            roomModule.partitionType = currElement;
-            moduleStack.push(roomModule);
-            room_map[roomModule.name] = roomModule;
-            ++roomCount;
-
         }
         else
         {
             // element is operand => add to stack
-            moduleStack.push(moduleList[currElement]);
+            currNode.moduleId = moduleStore.find_id(currElement);
+            currNode.width = moduleStore.width(currNode.moduleId);
+            currNode.height = moduleStore.height(currNode.moduleId);
+            stackArea += (double)currNode.width * currNode.height;
+            remainingArea -= moduleStore.area(currNode.moduleId);
         }
+        nodeStack.push_back(index);
         ++index;
     }
-    cirModule_t topRoom = moduleStack.top();
-    float totalArea = topRoom.width * topRoom.height;
+    const areaNode_t& topRoom = nodeList[nodeStack.back()];
+    float totalArea = outline ? outline_cost(topRoom.width, topRoom.height, *outline) : topRoom.width * topRoom.height;
+    if (outChipBox)
+    {
+        outChipBox->width = topRoom.width;
+        outChipBox->height = topRoom.height;
+    }
 
     if (generatePlotData)
     {
-        // Build the graph plotting data from the room_map
+        // Build the graph plotting data from the node list
         // to generate required data for plotting through python
         // in matplotlib
-        
+
         // Clear the past placement data if any
-        for (auto x : moduleList)
-        {
-            moduleList[x.first].placement = std::make_pair(0, 0);
-        }
-        // Room related data already clear
+        moduleStore.clear_placement();
+        nodeList[nodeStack.back()].x = 0;
+        nodeList[nodeStack.back()].y = 0;
 
-        // Re-using the moduleStack
-        while (not moduleStack.empty())
+        for (int i = (int)nodeList.size() - 1; i >= 0; --i)
         {
-            cirModule_t currentRoom = moduleStack.top();
-            moduleStack.pop();
-            if (currentRoom.isModule)
+            const areaNode_t& currentRoom = nodeList[i];
+            if (currentRoom.moduleId != -1)
             {
-                // Update the reference in moduleList
-                moduleList[currentRoom.name].placement = currentRoom.placement;
+                // Update the placement in module store
+                moduleStore.set_placement(currentRoom.moduleId, currentRoom.x, currentRoom.y);
                 continue;
             }
-            cirModule_t module1, module2;
-            // Get room1
-            if (currentRoom.isModule1mod == false)
-            {
-                // module 1 is room
-                module1 = room_map[currentRoom.module1];
-            }
-            else
-            {
-                // module 1 is module
-                module1 = moduleList[currentRoom.module1];
-            }
-            // Get room2
-            if (currentRoom.isModule2mod == false)
-            {
-                // module 2 is room
-                module2 = room_map[currentRoom.module2];
-            }
-            else
-            {
-                // module 2 is module
-                module2 = moduleList[currentRoom.module2];
-            }
+            areaNode_t& module1 = nodeList[currentRoom.child1];
+            areaNode_t& module2 = nodeList[currentRoom.child2];
             // Module 1 is either the left or bottom irrespective of partition
             // so, its x,y will be same as currentRoom
-            module1.placement = currentRoom.placement;
-            // Add module1 to stack
-            moduleStack.push(module1);
+            module1.x = currentRoom.x;
+            module1.y = currentRoom.y;
 
-            // Calculate the x,y for module1
-            if (is_horizontal_partition(currentRoom.partitionType))
+            // Calculate the x,y for module2
+            if (currentRoom.isHorizontal)
             {
                 // H_t
-                module2.placement = std::make_pair(currentRoom.placement.first, currentRoom.placement.second + module1.height);
+                module2.x = currentRoom.x;
+                module2.y = currentRoom.y + module1.height;
             }
             else // V_t
             {
-                module2.placement = std::make_pair(currentRoom.placement.first + module1.width, currentRoom.placement.second);
+                module2.x = currentRoom.x + module1.width;
+                module2.y = currentRoom.y;
             }
-            // Add module2 to stack
-            moduleStack.push(module2);
         }
     }
 
@@ -337,20 +500,75 @@ float compute_area_wrapper(std::vector<std::string>& currList,
 */
 float PolishExpression::compute_area(bool generatePlotData)
 {
-    this->clear_module_placement();
-    return compute_area_wrapper(this->currExp, this->moduleList, generatePlotData);
+    // NOTE: Placement is cleared by compute_area_wrapper when plot data is generated
+    if (this->evalThreadCount != 1 && (int)this->currExp.size() >= PARALLELEVALMINSIZE &&
+        !this->moduleStore.has_flexible_modules())
+    {
+        // Sibling subtrees on separate threads
+        this->isChipBoxValid = true;
+        return compute_area_parallel(this->currExp, this->operandCountVec, this->operatorCountVec, this->moduleStore,
+            generatePlotData, this->evalThreadCount, is_outline_active(this->outline) ? &this->outline : NULL, &this->lastChipBox);
+    }
+    this->isChipBoxValid = true;
+    return compute_area_wrapper(this->currExp, this->moduleStore, generatePlotData,
+        std::numeric_limits<float>::infinity(), is_outline_active(this->outline) ? &this->outline : NULL, &this->lastChipBox);
+}
+
+/*
+* Function to compute the chip box (places the modules)
+* @param outWidth -> chip width
+* @param outHeight -> chip height
+*/
+void PolishExpression::compute_chip_size(float& outWidth, float& outHeight)
+{
+    this->compute_area(true);
+    outWidth = 0;
+    outHeight = 0;
+    for (int id = 0; id < this->moduleStore.size(); ++id)
+    {
+        outWidth = std::max(outWidth, this->moduleStore.placement_x(id) + this->moduleStore.width(id));
+        outHeight = std::max(outHeight, this->moduleStore.placement_y(id) + this->moduleStore.height(id));
+    }
 }
 
 /*
-* Function to find random operator
-* @return index of operator
+* Function to compute area, stopping once it is proven above a bound
+* @param costBound -> area above which the exact value is not needed
+* @return float of area value, or a lower bound above costBound
+*/
+float PolishExpression::compute_bounded_area(float costBound)
+{
+    // Box is only written when the evaluation reaches the root
+    this->lastChipBox.width = -1;
+    float area = compute_area_wrapper(this->currExp, this->moduleStore, false, costBound,
+        is_outline_active(this->outline) ? &this->outline : NULL, &this->lastChipBox);
+    this->isChipBoxValid = this->lastChipBox.width >= 0;
+    return area;
+}
+
+/*
+* Function to find a random operator or operand in the move window
+* @param findOperator -> operator if true, operand otherwise
+* @return index of the element, -1 if the window holds none
 */
 int PolishExpression::find_element(bool findOperator)
 {
+    if (this->currExp.empty())
+    {
+        return -1;
+    }
+    int windowSize = this->window_end() - this->moveWindowBegin;
+    int operandCount = this->get_move_module_count();
+    // Sampling below would never end
+    if ((findOperator ? windowSize - operandCount : operandCount) <= 0)
+    {
+        return -1;
+    }
+    std::uniform_int_distribution<int> indexDistribution(this->moveWindowBegin, this->window_end() - 1);
     int indexToCheck;
     do
     {
-        indexToCheck = randDistribution(randGenerator) % this->currExp.size();
+        indexToCheck = indexDistribution(this->randGenerator);
     } while (is_operator(this->currExp[indexToCheck]) != findOperator);
     return indexToCheck;
 }
@@ -364,6 +582,10 @@ int PolishExpression::find_element(bool findOperator)
 */
 bool PolishExpression::moveM1()
 {
+    if (this->currExp.empty() || this->get_move_module_count() < 2)
+    {
+        return false;
+    }
     int index1 = this->find_element(false);
     int index2;
     do
@@ -372,6 +594,8 @@ bool PolishExpression::moveM1()
     } while (index1 == index2);
     // Safe to swap index1 and index2
     this->op_swap(index1, index2);
+    this->lastMoveIndex1 = index1;
+    this->lastMoveIndex2 = index2;
     return true;
 }
 
@@ -388,24 +612,44 @@ bool PolishExpression::moveM1()
 bool PolishExpression::moveM2()
 {
     int index = this->find_element(true);
+    if (index == -1)
+    {
+        return false;
+    }
+    this->invert_chain(index);
+    this->lastMoveIndex1 = index;
+    this->lastMoveIndex2 = -1;
+    return true;
+}
+
+/*
+* Function to invert the operator chain holding an index
+* @param index -> index of an operator in the chain
+*
+* NOTE: The whole chain is inverted, also past the move window.
+* A window ending at a right child cuts the chain of its parents,
+* inverting only the part inside would leave HH/VV (not normalized)
+*/
+void PolishExpression::invert_chain(int index)
+{
     int mainIndex = index;
+    int expressionSize = (int)currExp.size();
     // Invert the partition type
     currExp[index] = invert_partition(currExp[index]);
     // Look for partition chain prior to this index
-    while (index!= 0 && is_operator(currExp[index - 1]))
+    while (index != 0 && is_operator(currExp[index - 1]))
     {
         --index;
         // Invert the partition type
         currExp[index] = invert_partition(currExp[index]);
     }
     // Look for partition chain after the main index
-    while (mainIndex != (this->currExp.size() - 1) && is_operator(currExp[mainIndex + 1]))
+    while (mainIndex != (expressionSize - 1) && is_operator(currExp[mainIndex + 1]))
     {
         ++mainIndex;
         // Invert the partition type
         currExp[mainIndex] = invert_partition(currExp[mainIndex]);
     }
-    return true;
 }
 
 /*
@@ -417,6 +661,7 @@ bool PolishExpression::moveM2()
 */
 bool PolishExpression::moveM3()
 {
+    int windowEnd = this->window_end();
     bool moveSuccess = false;
     int triesLeft = M3TIMEOUT;
     //this->print_expression();
@@ -424,12 +669,16 @@ bool PolishExpression::moveM3()
     {
         int operandIndex, operatorIndex;
         operandIndex = this->find_element(false);
+        if (operandIndex == -1)
+        {
+            break;
+        }
         //int operatorIndex = this->find_element(true);
 
         // Supports only adjacent swaps
         // Check on index-1
         if (moveSuccess == false &&
-            operandIndex != 0 &&
+            operandIndex != this->moveWindowBegin &&
             is_operator(this->currExp[operandIndex - 1]) &&
             (2*this->operatorCountVec[operandIndex - 1] < (operandIndex+1)) &&
             // Check operand + 1 is not of the same type to make VV or HH post swap
@@ -454,11 +703,13 @@ bool PolishExpression::moveM3()
             else
             {
                 moveSuccess = true;
+                this->lastMoveIndex1 = operandIndex;
+                this->lastMoveIndex2 = operandIndex - 1;
             }
         }
         // Check on index+1
         else if (moveSuccess == false &&
-            operandIndex != (this->currExp.size() - 1) &&
+            operandIndex != (windowEnd - 1) &&
             is_operator(this->currExp[operandIndex + 1]) &&
             (2*this->operatorCountVec[operandIndex + 1] < operandIndex) &&
             // Check operand - 1 is not of the same type to make VV or HH post swap
@@ -474,7 +725,9 @@ bool PolishExpression::moveM3()
                 )
             )
         {
-            if (this->op_swap(operandIndex, operandIndex + 1, true) == false)
+            // Operator moving left must not take an operand from before the window
+            if (this->op_swap(operandIndex, operandIndex + 1, true) == false ||
+                !this->check_window_balloting_property(operandIndex))
             {
                 // revert back as swap not possible
                 this->op_swap(operandIndex + 1, operandIndex, true);
@@ -482,6 +735,8 @@ bool PolishExpression::moveM3()
             else
             {
                 moveSuccess = true;
+                this->lastMoveIndex1 = operandIndex;
+                this->lastMoveIndex2 = operandIndex + 1;
             }
         }
         --triesLeft;
@@ -516,31 +771,35 @@ void PolishExpression::print_expression(bool debug)
 
 /*
 * Print modules list
+* @param outStream -> stream to print to
 */
-void PolishExpression::print_modules()
+void PolishExpression::print_modules(std::ostream& outStream)
 {
-    std::cout << "Name\tWidth\tHeight\tX\tY\n";
-    for (auto x : this->moduleList)
+    outStream << "Name\tWidth\tHeight\tX\tY\n";
+    for (int id = 0; id < this->moduleStore.size(); ++id)
     {
-        std::cout << x.first << "\t" << x.second.width << "\t" << x.second.height << "\t" << x.second.placement.first << "\t" << x.second.placement.second << "\n";
+        outStream << this->moduleStore.name(id) << "\t" << this->moduleStore.width(id) << "\t" << this->moduleStore.height(id) << "\t"
+            << this->moduleStore.placement_x(id) << "\t" << this->moduleStore.placement_y(id) << "\n";
     }
 }
 
 /*
 * Generate plot file for python script
+* @param plotFile -> file to write
 */
-void PolishExpression::generate_plot_file()
+void PolishExpression::generate_plot_file(const std::string& plotFile)
 {
-    std::ofstream OUTFH("plot_data.txt");
+    std::ofstream OUTFH(plotFile);
     if (!OUTFH.is_open())
     {
-        std::cerr << "Unable to open the output plot data file: plot_data.txt\n";
+        std::cerr << "Unable to open the output plot data file: " << plotFile << "\n";
         return;
     }
     OUTFH << "Name\tWidth\tHeight\tX\tY\n";
-    for (auto x : this->moduleList)
+    for (int id = 0; id < this->moduleStore.size(); ++id)
     {
-        OUTFH << x.first << " " << x.second.width << " " << x.second.height << " " << x.second.placement.first << " " << x.second.placement.second << "\n";
+        OUTFH << this->moduleStore.name(id) << " " << this->moduleStore.width(id) << " " << this->moduleStore.height(id) << " "
+            << this->moduleStore.placement_x(id) << " " << this->moduleStore.placement_y(id) << "\n";
     }
 }
 
@@ -583,66 +842,38 @@ bool is_horizontal_partition(std::string inStr)
 * Function to select a move based on temperature
 * @param inTemp -> temperature
 * @param maxTemp -> maximum temperature
+* @param randPercent -> uniform random draw in [0, 99]
 * @return int of move type to run
 */
-int select_move(float inTemp, float maxTemp)
+int select_move(float inTemp, float maxTemp, int randPercent)
 {
     // Make bigger moves at high temp
-    int moveArr[100];
+    // Upper bound (exclusive) of the draw for M1 and M2, rest is M3
+    int m1Limit, m2Limit;
     float tempRatio = inTemp / maxTemp;
     if (tempRatio >= 0.75)
     {
         // Great chance of bigger moves
-        int i = 0;
-        for (; i < 25; ++i)
-        {
-            moveArr[i] = 1;
-        }
-        for (; i < (int)(25 + 75 / 2); ++i)
-        {
-            moveArr[i] = 2;
-        }
-        for (; i < 100; ++i)
-        {
-            moveArr[i] = 3;
-        }
+        m1Limit = 25;
+        m2Limit = (int)(25 + 75 / 2);
     }
     else if (tempRatio >= 0.25 && tempRatio < 0.75)
     {
         // Equal chance of all moves
-        int i = 0;
-        for (; i < (int)(100/3.0f); ++i)
-        {
-            moveArr[i] = 1;
-        }
-        for (; i < (int)(100*2/3.0f); ++i)
-        {
-            moveArr[i] = 2;
-        }
-        for (; i < 100; ++i)
-        {
-            moveArr[i] = 3;
-        }
+        m1Limit = (int)(100 / 3.0f);
+        m2Limit = (int)(100 * 2 / 3.0f);
     }
     else // tempRatio < 0.25
     {
         // Great chance of smaller moves
-        int i = 0;
-        for (; i < (int)(75 / 2.0f); ++i)
-        {
-            moveArr[i] = 1;
-        }
-        for (; i < 75; ++i)
-        {
-            moveArr[i] = 2;
-        }
-        for (; i < 100; ++i)
-        {
-            moveArr[i] = 3;
-        }
+        m1Limit = (int)(75 / 2.0f);
+        m2Limit = 75;
+    }
+    if (randPercent < m1Limit)
+    {
+        return 1;
     }
-    // Randomly select any move irrespective of temperature
-    return moveArr[randDistribution(randGenerator)];
+    return (randPercent < m2Limit) ? 2 : 3;
 }
 
 /*
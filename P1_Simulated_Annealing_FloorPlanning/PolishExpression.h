@@ -2,8 +2,14 @@
 #define __POLISH_EXPRESSION_H__
 
 #include <vector>
+#include <limits>
 #include <string>
+#include <iostream>
 #include <unordered_map>
+#include <random>
+
+#include "ModuleStore.h"
+#include "FixedOutline.h"
 
 /*
 * Run constraints
@@ -18,7 +24,10 @@
 
 /*
 * Type for the circuit modules
-* to hold all the relevant data
+* to hold all the relevant data from the input file
+*
+* NOTE: Only used to pass module data in, the module data is held
+* in the ModuleStore (structure-of-arrays) once added
 */
 typedef struct cirModule_t
 {
@@ -27,26 +36,31 @@ typedef struct cirModule_t
     float aspectRatio;
     float area;
     std::string name;
-    std::pair<float, float> placement;
-    // Room specific data (to be used if module is room)
-    bool isModule;
-    std::string module1;
-    bool isModule1mod; // if module1 is module
-    std::string module2;
-    bool isModule2mod; // if module2 is module
-    std::string partitionType;
+    // Shape freedom (soft module if min < max)
+    float minAspectRatio;
+    float maxAspectRatio;
+    bool isRotatable;
 } cirModule_t;
 
 /*
-* Type for custome return in the compute_area_wrapper
-* function
+* Type for the nodes of the slicing tree built
+* in the compute_area_wrapper function
 */
-typedef struct area_return_t
+typedef struct areaNode_t
 {
-    float width = 0;
-    float heigth = 0;
-    std::string name = "";
-} area_return_t;
+    float width;
+    float height;
+    // Placement (bottom left corner) of the node
+    float x;
+    float y;
+    // Module ID if leaf, -1 if room
+    int moduleId;
+    // Child node indices (room only)
+    int child1;
+    int child2;
+    // If room is horizontal partition
+    bool isHorizontal;
+} areaNode_t;
 
 class PolishExpression
 {
@@ -57,11 +71,42 @@ private:
     std::vector<int> operandCountVec;
     // To hold the operator count per index
     std::vector<int> operatorCountVec;
-    // To hold the moduleList
-    std::unordered_map<std::string, cirModule_t> moduleList;
+    // To hold the module data
+    ModuleStore moduleStore;
+    // Random number generator for the moves
+    std::default_random_engine randGenerator;
+    // Range of the expression the moves can touch [begin, end)
+    int moveWindowBegin;
+    int moveWindowEnd;
+    // Indices picked by the last move (-1 if unused), for move traces
+    int lastMoveIndex1;
+    int lastMoveIndex2;
+    // Fixed outline added to the cost (inactive by default)
+    fixedOutline_t outline;
+    // Threads for full evaluations of large hard module expressions (1 => serial)
+    int evalThreadCount;
+    // Chip box of the last evaluation that ran to the end, valid until the expression changes
+    chipBox_t lastChipBox;
+    bool isChipBoxValid;
+
+    /*
+    * Function to get the end of the move window
+    * @return index after the last index moves can touch
+    */
+    int window_end() const { return (this->moveWindowEnd < 0) ? (int)this->currExp.size() : this->moveWindowEnd; }
 
 public:
 
+    /*
+    * Type of the saved state used by the annealer to roll back moves
+    */
+    typedef std::vector<std::string> state_t;
+
+    /*
+    * Number of move types supported by apply_move (1..moveTypeCount)
+    */
+    static const int moveTypeCount = 3;
+
     /*
     * Base constructor
     */
@@ -79,6 +124,90 @@ public:
     */
     std::vector<std::string> get_polish_expression();
 
+    /*
+    * Getter for number of modules
+    * @return number of modules in module list
+    */
+    int get_module_count() { return this->moduleStore.size(); }
+
+    /*
+    * Getter for the module data
+    * @return module store held
+    */
+    const ModuleStore& get_module_store() const { return this->moduleStore; }
+
+    /*
+    * Function to take the modules from a binary module image (sa --compile)
+    * @param imageFile -> image to load
+    * @return bool if the image is valid
+    *
+    * NOTE: Replaces the modules, same as add_module for each module of the image
+    */
+    bool load_module_image(const std::string& imageFile) { this->isChipBoxValid = false; return this->moduleStore.load_image(imageFile); }
+
+    /*
+    * Function to seed the random number generator of the moves
+    * @param seed -> seed value
+    */
+    void set_seed(unsigned int seed);
+
+    /*
+    * Function to restrict the moves to a range of the expression
+    * @param begin -> first index moves can touch
+    * @param end -> index after the last index moves can touch (-1 => end of expression)
+    *
+    * NOTE: Window must hold at least 2 operands and 1 operator
+    */
+    void set_move_window(int begin, int end);
+
+    /*
+    * Getter for the move window
+    * @param outBegin -> first index moves can touch
+    * @param outEnd -> index after the last index moves can touch (-1 => end of expression)
+    */
+    void get_move_window(int& outBegin, int& outEnd) const { outBegin = this->moveWindowBegin; outEnd = this->moveWindowEnd; }
+
+    /*
+    * Function to get the number of operands moves can touch
+    * @return operand count in the move window
+    */
+    int get_move_module_count();
+
+    /*
+    * Function to save the current polish expression
+    * @param outState -> state to copy into (capacity is reused)
+    */
+    void save_state(state_t& outState) const;
+
+    /*
+    * Function to restore a saved polish expression
+    * @param inState -> state saved by save_state
+    */
+    void restore_state(const state_t& inState);
+
+    /*
+    * Function to perform a move by type
+    * @param moveType -> 1: M1, 2: M2, 3: M3
+    * @return bool -> if move successful
+    */
+    bool apply_move(int moveType);
+
+    /*
+    * Getter for the indices picked by the last successful move
+    * @param outIndex1 -> M1: first operand, M2: operator in the chain, M3: operand
+    * @param outIndex2 -> M1: second operand, M2: -1, M3: operator
+    */
+    void get_last_move(int& outIndex1, int& outIndex2) const { outIndex1 = this->lastMoveIndex1; outIndex2 = this->lastMoveIndex2; }
+
+    /*
+    * Function to perform a move at given indices (no random draws)
+    * @param moveType -> 1: M1, 2: M2, 3: M3
+    * @param index1 -> first index as given by get_last_move
+    * @param index2 -> second index as given by get_last_move
+    * @return bool -> if move successful (expression unchanged otherwise)
+    */
+    bool apply_recorded_move(int moveType, int index1, int index2);
+
     /*
     * Function to clear the module placement data
     */
@@ -118,6 +247,15 @@ public:
     */
     bool check_balloting_property(int index);
 
+    /*
+    * Function to verify balloting property from the move window begin
+    * @param index -> index in the move window to check balloting at
+    * @return bool if balloting property satisfied inside the window
+    *
+    * Logic: #operands > #operators counted from moveWindowBegin, keeps the window one subtree
+    */
+    bool check_window_balloting_property(int index);
+
     /*
     * Function to compute area
     * @param generatePlotData: if plot data needs to be generated for python script
@@ -125,6 +263,50 @@ public:
     */
     float compute_area(bool generatePlotData = false);
 
+    /*
+    * Function to compute area, stopping once it is proven above a bound
+    * @param costBound -> area above which the exact value is not needed
+    * @return float of area value, or a lower bound above costBound
+    */
+    float compute_bounded_area(float costBound);
+
+    /*
+    * Function to set the fixed outline
+    * @param inOutline -> outline (inactive => plain area)
+    *
+    * NOTE: With an active outline compute_area and compute_bounded_area return
+    * area + penalty for the chip area outside the outline
+    */
+    void set_outline(const fixedOutline_t& inOutline) { this->outline = inOutline; }
+
+    /*
+    * Getter for the fixed outline
+    */
+    const fixedOutline_t& get_outline() const { return this->outline; }
+
+    /*
+    * Setter for the threads of full evaluations
+    * @param threadCount -> threads (0 => hardware concurrency, 1 => serial)
+    *
+    * NOTE: Only compute_area of hard module expressions of at least PARALLELEVALMINSIZE
+    * elements runs in parallel (compute_area_parallel), bounded evaluation stays serial
+    */
+    void set_eval_threads(int threadCount) { this->evalThreadCount = threadCount; }
+
+    /*
+    * Function to compute the chip box (places the modules)
+    * @param outWidth -> chip width
+    * @param outHeight -> chip height
+    */
+    void compute_chip_size(float& outWidth, float& outHeight);
+
+    /*
+    * Getter for the chip box of the last evaluation of the current expression
+    * @param outBox -> chip box
+    * @return bool if the current expression was evaluated to the end (no early exit, no change since)
+    */
+    bool get_last_chip_box(chipBox_t& outBox) const { outBox = this->lastChipBox; return this->isChipBoxValid; }
+
     /*
     * Function to swap elements and update count vec
     * @param operandIndex -> index of operand
@@ -135,11 +317,20 @@ public:
     bool op_swap(int operandIndex, int operatorIndex, bool updateCounters);
 
     /*
-    * Function to find random operator
-    * @return index of operator
+    * Function to find a random operator or operand in the move window
+    * @param findOperator -> operator if true, operand otherwise
+    * @return index of the element, -1 if the window holds none
     */
     int find_element(bool findOperator);
 
+    /*
+    * Function to invert the operator chain holding an index
+    * @param index -> index of an operator in the chain
+    *
+    * NOTE: The whole chain is inverted, also past the move window
+    */
+    void invert_chain(int index);
+
     /*
     * Function to perform move M1 operand swap
     * @return bool -> if move successful
@@ -173,13 +364,15 @@ public:
 
     /*
     * Print modules list
+    * @param outStream -> stream to print to
     */
-    void print_modules();
+    void print_modules(std::ostream& outStream = std::cout);
 
     /*
     * Generate plot file for python script
+    * @param plotFile -> file to write
     */
-    void generate_plot_file();
+    void generate_plot_file(const std::string& plotFile = "plot_data.txt");
 
     /*
     * Destructor for the class
@@ -190,18 +383,26 @@ public:
 /*
 * Function to compute the area through the tree (post-ordered)
 * @param currList: current expression
-* @param moduleList: module details map
+* @param moduleStore: module details table
 * @param generatePlotData: if plot data needs to be generated for python script
-* @return data struct of width, height, name (if return from leaf node)
+* @return float of area value
+*
+* @param costBound: stop once the area is proven above this value (no plot data)
+* @param outline: fixed outline (NULL => none), adds the penalty for the area outside it
+* @param outChipBox: chip box of the root room (NULL => not needed), left unchanged on early exit
+* @return float of area value, or a lower bound above costBound on early exit
 *
-* NOTE: name will be used to create placement data for graph
+* NOTE: If any module is soft or rotatable, the area is computed through
+* shape curves (compute_shape_area_wrapper) instead, without early exit
 *
 * Logic: Using stack based approach to ensure that logic follow bottom left to top right logic
 * which requires iterating from left to right.
 * Recursion based approach goes from right to left -> reverse => placement computation will be complicated
 */
 float compute_area_wrapper(std::vector<std::string>& currList,
-    std::unordered_map<std::string, cirModule_t>& moduleList, bool generatePlotData);
+    ModuleStore& moduleStore, bool generatePlotData,
+    float costBound = std::numeric_limits<float>::infinity(), const fixedOutline_t* outline = NULL,
+    chipBox_t* outChipBox = NULL);
 
 /*
 * Function to check if element is operator
@@ -228,9 +429,10 @@ bool is_horizontal_partition(std::string inStr);
 * Function to select a move based on temperature
 * @param inTemp -> temperature
 * @param maxTemp -> maximum temperature
+* @param randPercent -> uniform random draw in [0, 99]
 * @return int of move type to run
 */
-int select_move(float inTemp, float maxTemp);
+int select_move(float inTemp, float maxTemp, int randPercent);
 
 /*
 * Function to flip the partition
@@ -0,0 +1,364 @@
+
+#include <iostream>
+#include <stdexcept>
+
+#include "RunOptions.h"
+
+/*
+* Function to print the command line usage
+*/
+void print_usage()
+{
+    std::cerr << "Usage: ./sa <input_file> [options]\n"
+        << "       ./sa --server <socket_path> [options]\n"
+        << "       ./sa --batch <batch_file> [options]\n"
+        << "       ./sa --benchmark <bench_file> [options]\n"
+        << "Input file format: <module_name> <area> <aspect_ratio> [<min_aspect_ratio> <max_aspect_ratio>] [<rotatable>]\n"
+        << "Options:\n"
+        << "  --solver <auto|exact|anneal>  solver selection (auto: exact for small hard designs)\n"
+        << "  --threads <n>                 worker threads for parallel modes\n"
+        << "  --islands <n>                 anneal in n forked processes sharing elite solutions\n"
+        << "  --lns <0|1>                   polish the annealed floorplan by re-optimizing 6-10 module subtrees\n"
+        << "  --seed <n>                    seed for the random number generators\n"
+        << "  --temp-start <t>              starting temperature (default 1000)\n"
+        << "  --temp-min <t>                lowest temperature to anneal till (default 10)\n"
+        << "  --temp-scaling <f>            cool down rate per temperature step, 0 < f < 1 (default 0.9)\n"
+        << "  --run-multiplier <k>          moves per temperature per module (default 5000)\n"
+        << "  --timeout <minutes>           time out of one anneal (default 5)\n"
+        << "  --tune <0|1>                  search the four parameters above by successive halving of short runs\n"
+        << "  --init <random|balanced|shelf|mincut>  initial solution (constructive ones start cooler)\n"
+        << "  --moves <schedule|adaptive>   move type selection (adaptive: by improvement per ns)\n"
+        << "  --eval <bounded|full>         move evaluation (bounded: stop once a move is sure to be rejected)\n"
+        << "  --speculate <k>               evaluate k moves of the chain at once on k threads, commit the first accepted\n"
+        << "  --profile <0|1>               hardware counters per temperature step and move type (Linux perf)\n"
+        << "  --outline <W>x<H>             fixed outline, area outside it is penalized (anneal only)\n"
+        << "  --whitespace <percent>        stop once a floorplan inside the outline has at most this whitespace\n"
+        << "  --trace-record <trace_file>   write the moves and decisions of the anneal to a binary trace\n"
+        << "  --trace-replay <trace_file>   re-run a recorded trace on the same input (no RNG, no Metropolis test)\n"
+        << "  --netlist <netlist_file>      nets as <net_name> <module_name> <module_name> [...]\n"
+        << "  --pareto <pareto_file>        write the area / aspect / wirelength trade-off floorplans of the anneal\n"
+        << "  --eco <expression_file>       warm start from a previous best polish expression\n"
+        << "  --delta <delta_file>          module changes for --eco (add/update <module line>, remove <name>)\n"
+        << "  --server <socket_path>        run as a daemon taking jobs on a Unix socket (options are job defaults)\n"
+        << "  --batch <batch_file>          run one job per line (<input_file> [options]), overlapping file I/O and anneals\n"
+        << "  --benchmark <bench_file>      area over time of engines (engine <name> [options]) on designs over seeds, CSV output\n"
+        << "  --compile <image_file>        write the modules as a binary image to use as input file of later runs\n";
+}
+
+/*
+* Function to parse the command line
+* @param argc -> argument count
+* @param argv -> arguments
+* @param outOptions -> options to fill
+* @return bool if command line is valid
+*/
+bool parse_run_options(int argc, char** argv, runOptions_t& outOptions)
+{
+    std::vector<std::string> args(argv + 1, argv + argc);
+    if (!parse_run_options(args, outOptions, true))
+    {
+        return false;
+    }
+    int modeCount = !outOptions.serverSocket.empty() + !outOptions.batchFile.empty() + !outOptions.benchmarkFile.empty();
+    if (modeCount > 0 && !outOptions.inputFile.empty())
+    {
+        std::cerr << "--server, --batch and --benchmark take the modules from the jobs, not an input file\n";
+        return false;
+    }
+    if (modeCount > 1)
+    {
+        std::cerr << "--server, --batch and --benchmark cannot be combined\n";
+        return false;
+    }
+    return true;
+}
+
+/*
+* Function to check the options of a job run next to other jobs (server, batch, benchmark)
+* @param jobOptions -> parsed options of the job
+* @param jobSource -> JOBSOURCE_SERVER, JOBSOURCE_BATCH or JOBSOURCE_BENCHMARK
+* @param outReason -> why the options are rejected
+* @return bool if run_floorplan can run the job as given
+*/
+bool validate_job_options(const runOptions_t& jobOptions, int jobSource, std::string& outReason)
+{
+    if (!jobOptions.serverSocket.empty() || !jobOptions.batchFile.empty() || !jobOptions.benchmarkFile.empty())
+    {
+        outReason = "--server, --batch and --benchmark are not job options";
+    }
+    // Handled by main only, run_floorplan would ignore them
+    else if (!jobOptions.compileFile.empty() || jobOptions.tuneParameters)
+    {
+        outReason = "--compile and --tune are not job options";
+    }
+    // Islands fork, not safe next to the worker threads
+    else if (jobOptions.islandCount > 1)
+    {
+        outReason = "--islands is not a job option";
+    }
+    else if ((jobSource == JOBSOURCE_BATCH) != !jobOptions.inputFile.empty())
+    {
+        outReason = (jobSource == JOBSOURCE_BATCH) ? "missing input file" : "modules come from the job, not an input file";
+    }
+    // Server and batch: one thread per job, speculation would start k more
+    else if (jobSource != JOBSOURCE_BENCHMARK && jobOptions.speculativeMoves > 1)
+    {
+        outReason = "--speculate is not a job option";
+    }
+    // Server: concurrent jobs (and the defaults of every job) would write the same files
+    // Benchmark: written per run, every design and seed would write the same file
+    else if (jobSource != JOBSOURCE_BATCH && (!jobOptions.traceRecordFile.empty() || !jobOptions.paretoFile.empty()))
+    {
+        outReason = "--trace-record and --pareto are not job options";
+    }
+    // Benchmark: trace and ECO inputs belong to one design
+    else if (jobSource == JOBSOURCE_BENCHMARK && (!jobOptions.traceReplayFile.empty() || !jobOptions.ecoExpressionFile.empty()))
+    {
+        outReason = "--trace-replay and --eco are not engine options";
+    }
+    else
+    {
+        return true;
+    }
+    return false;
+}
+
+/*
+* Function to parse a list of options, numeric conversions may throw
+* @param args -> arguments without the program name
+* @param outOptions -> options to fill (unset options keep their value)
+* @param needInputFile -> if the input file argument is required
+* @return bool if the options are valid
+*/
+static bool parse_option_list(const std::vector<std::string>& args, runOptions_t& outOptions, bool needInputFile)
+{
+    int argc = (int)args.size();
+    for (int i = 0; i < argc; ++i)
+    {
+        const std::string& currArg = args[i];
+        // Options with a value
+        if (currArg.compare(0, 2, "--") == 0 && i + 1 >= argc)
+        {
+            std::cerr << "Missing value for option " << currArg << "\n";
+            return false;
+        }
+        if (currArg == "--solver")
+        {
+            outOptions.solver = args[++i];
+            if (outOptions.solver != "auto" && outOptions.solver != "exact" && outOptions.solver != "anneal")
+            {
+                std::cerr << "Invalid solver " << outOptions.solver << "\n";
+                return false;
+            }
+        }
+        else if (currArg == "--threads")
+        {
+            outOptions.threadCount = std::stoi(args[++i]);
+        }
+        else if (currArg == "--islands")
+        {
+            outOptions.islandCount = std::stoi(args[++i]);
+            if (outOptions.islandCount < 1)
+            {
+                std::cerr << "Invalid island count " << outOptions.islandCount << "\n";
+                return false;
+            }
+        }
+        else if (currArg == "--lns")
+        {
+            outOptions.lnsPolish = std::stoi(args[++i]) != 0;
+        }
+        else if (currArg == "--seed")
+        {
+            outOptions.config.seed = (unsigned int)std::stoul(args[++i]);
+        }
+        else if (currArg == "--temp-start" || currArg == "--temp-min" || currArg == "--temp-scaling" ||
+            currArg == "--timeout")
+        {
+            float value = std::stof(args[++i]);
+            if (value <= 0 || (currArg == "--temp-scaling" && value >= 1))
+            {
+                std::cerr << "Invalid value " << value << " for " << currArg << "\n";
+                return false;
+            }
+            float& configValue = (currArg == "--temp-start") ? outOptions.config.initialTemperature :
+                (currArg == "--temp-min") ? outOptions.config.tempConstraint :
+                (currArg == "--temp-scaling") ? outOptions.config.tempScaling : outOptions.config.timeOut;
+            configValue = value;
+        }
+        else if (currArg == "--run-multiplier")
+        {
+            outOptions.config.runMultiplier = std::stoi(args[++i]);
+            if (outOptions.config.runMultiplier < 1)
+            {
+                std::cerr << "Invalid run multiplier " << outOptions.config.runMultiplier << "\n";
+                return false;
+            }
+        }
+        else if (currArg == "--tune")
+        {
+            outOptions.tuneParameters = std::stoi(args[++i]) != 0;
+        }
+        else if (currArg == "--init")
+        {
+            outOptions.initMethod = args[++i];
+        }
+        else if (currArg == "--moves")
+        {
+            outOptions.moveSelection = args[++i];
+            if (outOptions.moveSelection != "schedule" && outOptions.moveSelection != "adaptive")
+            {
+                std::cerr << "Invalid move selection " << outOptions.moveSelection << "\n";
+                return false;
+            }
+        }
+        else if (currArg == "--eval")
+        {
+            std::string evalMode = args[++i];
+            if (evalMode != "bounded" && evalMode != "full")
+            {
+                std::cerr << "Invalid evaluation mode " << evalMode << "\n";
+                return false;
+            }
+            outOptions.config.boundedEvaluation = (evalMode == "bounded");
+        }
+        else if (currArg == "--speculate")
+        {
+            outOptions.speculativeMoves = std::stoi(args[++i]);
+            if (outOptions.speculativeMoves < 1)
+            {
+                std::cerr << "Invalid speculative move count " << outOptions.speculativeMoves << "\n";
+                return false;
+            }
+        }
+        else if (currArg == "--profile")
+        {
+            outOptions.profileCounters = std::stoi(args[++i]) != 0;
+        }
+        else if (currArg == "--outline")
+        {
+            const std::string& outlineArg = args[++i];
+            size_t separator = outlineArg.find('x');
+            if (separator == std::string::npos ||
+                (outOptions.outline.width = std::stof(outlineArg.substr(0, separator))) <= 0 ||
+                (outOptions.outline.height = std::stof(outlineArg.substr(separator + 1))) <= 0)
+            {
+                std::cerr << "Invalid outline " << outlineArg << " (expected <width>x<height>)\n";
+                return false;
+            }
+        }
+        else if (currArg == "--whitespace")
+        {
+            float whitespacePercent = std::stof(args[++i]);
+            if (whitespacePercent <= 0 || whitespacePercent >= 100)
+            {
+                std::cerr << "Invalid whitespace target " << whitespacePercent << "\n";
+                return false;
+            }
+            outOptions.config.whitespaceTarget = whitespacePercent / 100;
+        }
+        else if (currArg == "--trace-record")
+        {
+            outOptions.traceRecordFile = args[++i];
+        }
+        else if (currArg == "--trace-replay")
+        {
+            outOptions.traceReplayFile = args[++i];
+        }
+        else if (currArg == "--netlist")
+        {
+            outOptions.netlistFile = args[++i];
+        }
+        else if (currArg == "--pareto")
+        {
+            outOptions.paretoFile = args[++i];
+        }
+        else if (currArg == "--eco")
+        {
+            outOptions.ecoExpressionFile = args[++i];
+        }
+        else if (currArg == "--delta")
+        {
+            outOptions.ecoDeltaFile = args[++i];
+        }
+        else if (currArg == "--server")
+        {
+            outOptions.serverSocket = args[++i];
+        }
+        else if (currArg == "--compile")
+        {
+            outOptions.compileFile = args[++i];
+        }
+        else if (currArg == "--batch")
+        {
+            outOptions.batchFile = args[++i];
+        }
+        else if (currArg == "--benchmark")
+        {
+            outOptions.benchmarkFile = args[++i];
+        }
+        else if (currArg.compare(0, 2, "--") == 0)
+        {
+            std::cerr << "Unknown option " << currArg << "\n";
+            return false;
+        }
+        else if (outOptions.inputFile.empty())
+        {
+            outOptions.inputFile = currArg;
+        }
+        else
+        {
+            std::cerr << "Unexpected argument " << currArg << "\n";
+            return false;
+        }
+    }
+    if (!outOptions.ecoDeltaFile.empty() && outOptions.ecoExpressionFile.empty())
+    {
+        std::cerr << "--delta needs --eco\n";
+        return false;
+    }
+    if (!outOptions.traceRecordFile.empty() && !outOptions.traceReplayFile.empty())
+    {
+        std::cerr << "--trace-record and --trace-replay cannot be combined\n";
+        return false;
+    }
+    // Per move hooks of the serial annealer (files would be opened and left empty)
+    if (outOptions.speculativeMoves > 1 &&
+        (!outOptions.traceRecordFile.empty() || outOptions.profileCounters || !outOptions.paretoFile.empty()))
+    {
+        std::cerr << "--speculate cannot be combined with --trace-record, --profile or --pareto\n";
+        return false;
+    }
+    // Server, batch and benchmark modes get the modules from the jobs
+    if (needInputFile && outOptions.serverSocket.empty() && outOptions.batchFile.empty() && outOptions.benchmarkFile.empty())
+    {
+        return !outOptions.inputFile.empty();
+    }
+    return true;
+}
+
+/*
+* Function to parse a list of options (command line or server job line)
+* @param args -> arguments without the program name
+* @param outOptions -> options to fill (unset options keep their value)
+* @param needInputFile -> if the input file argument is required
+* @return bool if the options are valid
+*
+* NOTE: Never throws, bad numbers from server or batch jobs must not end the process
+*/
+bool parse_run_options(const std::vector<std::string>& args, runOptions_t& outOptions, bool needInputFile)
+{
+    try
+    {
+        return parse_option_list(args, outOptions, needInputFile);
+    }
+    catch (const std::invalid_argument&)
+    {
+        std::cerr << "Invalid number in options\n";
+    }
+    catch (const std::out_of_range&)
+    {
+        std::cerr << "Number out of range in options\n";
+    }
+    return false;
+}
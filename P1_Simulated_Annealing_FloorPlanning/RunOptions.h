@@ -0,0 +1,99 @@
+#ifndef __RUN_OPTIONS_H__
+#define __RUN_OPTIONS_H__
+
+#include <string>
+#include <vector>
+
+#include "Annealer.h"
+
+/*
+* Sources of jobs (validate_job_options)
+*/
+// Job of a server connection (modules from library / module lines)
+#define JOBSOURCE_SERVER 0
+// Line of a batch file (modules from its input file)
+#define JOBSOURCE_BATCH 1
+// Engine of a benchmark (modules from the design lines)
+#define JOBSOURCE_BENCHMARK 2
+
+/*
+* Type for the command line options of sa
+*/
+typedef struct runOptions_t
+{
+    std::string inputFile;
+    // Annealing configuration
+    annealConfig_t config;
+    // Solver to use: auto (exact below EXACTTHRESHOLD modules), exact or anneal
+    std::string solver = "auto";
+    // Worker threads for parallel modes (0 => hardware concurrency)
+    int threadCount = 0;
+    // Annealing processes of the island model (1 => single anneal)
+    int islandCount = 1;
+    // Re-optimize small subtrees after the anneal
+    bool lnsPolish = false;
+    // Search the annealing parameters instead of a single run
+    bool tuneParameters = false;
+    // Initial solution: random, balanced, shelf or mincut
+    std::string initMethod = "random";
+    // Move type selection: schedule (temperature tables) or adaptive
+    std::string moveSelection = "schedule";
+    // Moves evaluated at once from the same state (1 => serial annealer)
+    int speculativeMoves = 1;
+    // Read hardware counters around the annealing phases
+    bool profileCounters = false;
+    // Fixed die outline (width 0 => free outline, whitespace target in config)
+    fixedOutline_t outline;
+    // Move trace to write, or to replay instead of annealing (empty => none)
+    std::string traceRecordFile;
+    std::string traceReplayFile;
+    // Nets between the modules (empty => no netlist)
+    std::string netlistFile;
+    // Non-dominated area / aspect / wirelength floorplans of the anneal (empty => not kept)
+    std::string paretoFile;
+    // ECO: previous best expression and module delta (empty => normal run)
+    std::string ecoExpressionFile;
+    std::string ecoDeltaFile;
+    // Server mode: Unix socket path to listen on (empty => single run)
+    std::string serverSocket;
+    // Batch mode: job list to run through the pipeline (empty => single run)
+    std::string batchFile;
+    // Benchmark mode: designs and engines to compare over seeds (empty => single run)
+    std::string benchmarkFile;
+    // Binary module image to write from the input file instead of a run (empty => run)
+    std::string compileFile;
+} runOptions_t;
+
+/*
+* Function to print the command line usage
+*/
+void print_usage();
+
+/*
+* Function to parse the command line
+* @param argc -> argument count
+* @param argv -> arguments
+* @param outOptions -> options to fill
+* @return bool if command line is valid
+*/
+bool parse_run_options(int argc, char** argv, runOptions_t& outOptions);
+
+/*
+* Function to parse a list of options (command line or server job line)
+* @param args -> arguments without the program name
+* @param outOptions -> options to fill (unset options keep their value)
+* @param needInputFile -> if the input file argument is required
+* @return bool if the options are valid
+*/
+bool parse_run_options(const std::vector<std::string>& args, runOptions_t& outOptions, bool needInputFile);
+
+/*
+* Function to check the options of a job run next to other jobs (server, batch, benchmark)
+* @param jobOptions -> parsed options of the job
+* @param jobSource -> JOBSOURCE_SERVER, JOBSOURCE_BATCH or JOBSOURCE_BENCHMARK
+* @param outReason -> why the options are rejected
+* @return bool if run_floorplan can run the job as given
+*/
+bool validate_job_options(const runOptions_t& jobOptions, int jobSource, std::string& outReason);
+
+#endif // !__RUN_OPTIONS_H__
@@ -0,0 +1,420 @@
+
+#include <iostream>
+#include <sstream>
+#include <memory>
+#include <map>
+#include <set>
+#include <atomic>
+#include <cstring>
+
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "Server.h"
+#include "ThreadPool.h"
+#include "Floorplanner.h"
+#include "ModuleParser.h"
+#include "HelperFuncs.h"
+
+typedef std::shared_ptr<const std::vector<cirModule_t> > moduleLibraryPtr_t;
+
+/*
+* Cache of parsed module files shared by all jobs
+* (a file is parsed again only if its modification time changed)
+*/
+class ModuleLibraryCache
+{
+private:
+    typedef struct cacheEntry_t
+    {
+        time_t modifiedTime;
+        moduleLibraryPtr_t moduleList;
+    } cacheEntry_t;
+
+    std::map<std::string, cacheEntry_t> entryMap;
+    std::mutex cacheMutex;
+
+public:
+
+    /*
+    * Function to get the modules of a file
+    * @param inputFile -> module file
+    * @return parsed modules, null if the file is invalid
+    */
+    moduleLibraryPtr_t get(const std::string& inputFile)
+    {
+        struct stat fileStat;
+        if (stat(inputFile.c_str(), &fileStat) != 0)
+        {
+            return moduleLibraryPtr_t();
+        }
+        {
+            std::lock_guard<std::mutex> cacheLock(this->cacheMutex);
+            auto entryIt = this->entryMap.find(inputFile);
+            if (entryIt != this->entryMap.end() && entryIt->second.modifiedTime == fileStat.st_mtime)
+            {
+                return entryIt->second.moduleList;
+            }
+        }
+        // Parsed without the lock, a large file does not stall the other connections
+        // (two connections may parse the same new file, the last one is kept)
+        std::shared_ptr<std::vector<cirModule_t> > moduleList(new std::vector<cirModule_t>());
+        if (!read_module_file(inputFile, *moduleList))
+        {
+            return moduleLibraryPtr_t();
+        }
+        std::lock_guard<std::mutex> cacheLock(this->cacheMutex);
+        cacheEntry_t& currEntry = this->entryMap[inputFile];
+        currEntry.modifiedTime = fileStat.st_mtime;
+        currEntry.moduleList = moduleList;
+        return moduleList;
+    }
+};
+
+/*
+* Type for one client connection
+*/
+typedef struct serverConnection_t
+{
+    int socketFd;
+    // Replies from the workers are written under the mutex
+    std::mutex writeMutex;
+    // Jobs queued but not finished
+    int pendingJobs = 0;
+    std::mutex pendingMutex;
+    std::condition_variable pendingCondition;
+} serverConnection_t;
+
+/*
+* Type for a job being read from a connection
+*/
+typedef struct serverJob_t
+{
+    std::string jobId;
+    runOptions_t options;
+    std::vector<moduleLibraryPtr_t> libraryList;
+    std::vector<cirModule_t> inlineModules;
+    std::string errorMessage;
+} serverJob_t;
+
+/*
+* Function to send one reply line
+* @param connection -> client connection
+* @param message -> line without newline
+*/
+static void send_line(serverConnection_t& connection, const std::string& message)
+{
+    std::string currLine = message + "\n";
+    std::lock_guard<std::mutex> writeLock(connection.writeMutex);
+    size_t sentBytes = 0;
+    while (sentBytes < currLine.size())
+    {
+        ssize_t count = send(connection.socketFd, currLine.data() + sentBytes, currLine.size() - sentBytes, MSG_NOSIGNAL);
+        if (count <= 0)
+        {
+            // Client gone, result is dropped
+            return;
+        }
+        sentBytes += count;
+    }
+}
+
+/*
+* Function to run one job on a worker
+* @param connection -> client connection to reply on
+* @param job -> job to run
+*/
+static void run_job(const std::shared_ptr<serverConnection_t>& connection, const serverJob_t& job)
+{
+    // Anything thrown on a pool thread would terminate the daemon and the jobs of every client
+    try
+    {
+        std::vector<cirModule_t> moduleList;
+        for (auto& currLibrary : job.libraryList)
+        {
+            moduleList.insert(moduleList.end(), currLibrary->begin(), currLibrary->end());
+        }
+        moduleList.insert(moduleList.end(), job.inlineModules.begin(), job.inlineModules.end());
+
+        // Progress messages are not sent back
+        std::ostringstream logStream;
+        PolishExpression currPolishExpression;
+        floorplanResult_t result = run_floorplan(currPolishExpression, std::move(moduleList), job.options, logStream);
+        if (!result.isValid)
+        {
+            send_line(*connection, "error " + job.jobId + " invalid job input");
+        }
+        else
+        {
+            std::ostringstream replyStream;
+            replyStream << "result " << job.jobId << " " << result.solver << " " << result.chipArea << " " << result.runTime;
+            for (auto& element : currPolishExpression.get_polish_expression())
+            {
+                replyStream << " " << element;
+            }
+            send_line(*connection, replyStream.str());
+        }
+    }
+    catch (const std::exception& runError)
+    {
+        // Other jobs go on (e.g. bad_alloc of one huge design)
+        send_line(*connection, "error " + job.jobId + " floorplan failed: " + runError.what());
+    }
+
+    std::lock_guard<std::mutex> pendingLock(connection->pendingMutex);
+    --connection->pendingJobs;
+    connection->pendingCondition.notify_all();
+}
+
+/*
+* Type for the state shared by the server threads
+*/
+typedef struct serverState_t
+{
+    runOptions_t defaultOptions;
+    ModuleLibraryCache libraryCache;
+    ThreadPool* workerPool;
+    int listenFd;
+    std::atomic<bool> isStopping;
+    // Open connections (to wake up their readers on shutdown)
+    std::set<int> openSockets;
+    std::mutex socketMutex;
+    std::condition_variable socketCondition;
+} serverState_t;
+
+/*
+* Function to handle one command line of a connection
+* @param state -> server state
+* @param connection -> client connection
+* @param fields -> command line split on spaces
+* @param currJob -> job being read (null if none)
+*/
+static void handle_command(serverState_t& state, const std::shared_ptr<serverConnection_t>& connection,
+    const std::vector<std::string>& fields, std::unique_ptr<serverJob_t>& currJob)
+{
+    const std::string& command = fields[0];
+    if (command == "job")
+    {
+        if (fields.size() < 2)
+        {
+            send_line(*connection, "error - missing job id");
+            return;
+        }
+        currJob.reset(new serverJob_t());
+        currJob->jobId = fields[1];
+        currJob->options = state.defaultOptions;
+        currJob->options.config.verbose = false;
+        currJob->options.serverSocket.clear();
+        currJob->options.batchFile.clear();
+        currJob->options.benchmarkFile.clear();
+        // Parallelism comes from the pool, one thread per job unless asked
+        currJob->options.threadCount = 1;
+        currJob->options.speculativeMoves = 1;
+        std::vector<std::string> args(fields.begin() + 2, fields.end());
+        std::string invalidReason;
+        if (!parse_run_options(args, currJob->options, false))
+        {
+            currJob->errorMessage = "invalid options";
+        }
+        else if (!validate_job_options(currJob->options, JOBSOURCE_SERVER, invalidReason))
+        {
+            currJob->errorMessage = "invalid options: " + invalidReason;
+        }
+    }
+    else if (command == "shutdown")
+    {
+        state.isStopping = true;
+        // Wake up the accept call
+        shutdown(state.listenFd, SHUT_RDWR);
+    }
+    else if (!currJob)
+    {
+        send_line(*connection, "error - " + command + " outside of a job");
+    }
+    else if (command == "library" && fields.size() == 2)
+    {
+        moduleLibraryPtr_t moduleList = state.libraryCache.get(fields[1]);
+        if (!moduleList)
+        {
+            currJob->errorMessage = "invalid module file " + fields[1];
+        }
+        else
+        {
+            currJob->libraryList.push_back(moduleList);
+        }
+    }
+    else if (command == "module")
+    {
+        cirModule_t currModule;
+        if (!parse_module_fields(fields, 1, currModule))
+        {
+            currJob->errorMessage = "invalid module line";
+        }
+        else
+        {
+            currJob->inlineModules.push_back(currModule);
+        }
+    }
+    else if (command == "end")
+    {
+        std::unique_ptr<serverJob_t> readyJob(std::move(currJob));
+        if (!readyJob->errorMessage.empty())
+        {
+            send_line(*connection, "error " + readyJob->jobId + " " + readyJob->errorMessage);
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> pendingLock(connection->pendingMutex);
+            ++connection->pendingJobs;
+        }
+        send_line(*connection, "accepted " + readyJob->jobId);
+        std::shared_ptr<serverJob_t> queuedJob(readyJob.release());
+        state.workerPool->submit([connection, queuedJob]() { run_job(connection, *queuedJob); });
+    }
+    else
+    {
+        send_line(*connection, "error " + currJob->jobId + " unknown command " + command);
+    }
+}
+
+/*
+* Function to read the commands of one connection until the client closes it
+* @param state -> server state
+* @param socketFd -> accepted socket
+*/
+static void serve_connection(serverState_t& state, int socketFd)
+{
+    std::shared_ptr<serverConnection_t> connection(new serverConnection_t());
+    connection->socketFd = socketFd;
+    std::unique_ptr<serverJob_t> currJob;
+    std::string pendingData;
+    char readBuffer[SERVERREADSIZE];
+    ssize_t count;
+    while ((count = recv(socketFd, readBuffer, sizeof(readBuffer), 0)) > 0)
+    {
+        pendingData.append(readBuffer, count);
+        size_t lineEnd;
+        while ((lineEnd = pendingData.find('\n')) != std::string::npos)
+        {
+            std::string currentLine = pendingData.substr(0, lineEnd);
+            pendingData.erase(0, lineEnd + 1);
+            // Same cleanup as the input files
+            if (!currentLine.empty() && currentLine[currentLine.length() - 1] == '\r')
+            {
+                currentLine.erase(currentLine.length() - 1);
+            }
+            remove_tabs(currentLine);
+            remove_multiple_spaces(currentLine);
+            if (!currentLine.empty() && currentLine[0] == ' ')
+            {
+                currentLine.erase(0, 1);
+            }
+            if (!currentLine.empty() && currentLine[currentLine.length() - 1] == ' ')
+            {
+                currentLine.erase(currentLine.length() - 1);
+            }
+            if (currentLine.empty())
+            {
+                continue;
+            }
+            try
+            {
+                handle_command(state, connection, split_str(currentLine), currJob);
+            }
+            catch (const std::exception& commandError)
+            {
+                // e.g. bad_alloc parsing a huge library, the job is dropped and the server goes on
+                send_line(*connection, "error " + (currJob ? currJob->jobId : std::string("-")) + " command failed: " +
+                    commandError.what());
+                currJob.reset();
+            }
+        }
+    }
+
+    // Results of the queued jobs still go out before closing
+    {
+        std::unique_lock<std::mutex> pendingLock(connection->pendingMutex);
+        connection->pendingCondition.wait(pendingLock, [&]() { return connection->pendingJobs == 0; });
+    }
+    // Notify under the lock: run_server destroys state once the set is empty
+    std::lock_guard<std::mutex> socketLock(state.socketMutex);
+    close(socketFd);
+    state.openSockets.erase(socketFd);
+    state.socketCondition.notify_all();
+}
+
+/*
+* Function to run sa as a daemon on a Unix domain socket
+* @param socketPath -> path of the socket to create (replaced if it exists)
+* @param defaultOptions -> options every job starts from
+* @return bool if the server ran until a shutdown request
+*/
+bool run_server(const std::string& socketPath, const runOptions_t& defaultOptions)
+{
+    struct sockaddr_un address;
+    std::memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (socketPath.size() >= sizeof(address.sun_path))
+    {
+        std::cerr << "Socket path too long " << socketPath << "\n";
+        return false;
+    }
+    std::strncpy(address.sun_path, socketPath.c_str(), sizeof(address.sun_path) - 1);
+
+    int listenFd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listenFd < 0)
+    {
+        std::cerr << "Unable to create socket: " << std::strerror(errno) << "\n";
+        return false;
+    }
+    unlink(socketPath.c_str());
+    if (bind(listenFd, (struct sockaddr*)&address, sizeof(address)) != 0 || listen(listenFd, SERVERBACKLOG) != 0)
+    {
+        std::cerr << "Unable to listen on " << socketPath << ": " << std::strerror(errno) << "\n";
+        close(listenFd);
+        return false;
+    }
+
+    serverState_t state;
+    state.defaultOptions = defaultOptions;
+    state.listenFd = listenFd;
+    state.isStopping = false;
+    ThreadPool workerPool(defaultOptions.threadCount);
+    state.workerPool = &workerPool;
+    std::cout << "Listening on " << socketPath << " with " << workerPool.size() << " workers\n";
+
+    while (!state.isStopping)
+    {
+        int socketFd = accept(listenFd, NULL, NULL);
+        if (socketFd < 0)
+        {
+            if (errno == EINTR || errno == ECONNABORTED)
+            {
+                continue;
+            }
+            break;
+        }
+        {
+            std::lock_guard<std::mutex> socketLock(state.socketMutex);
+            state.openSockets.insert(socketFd);
+        }
+        // Readers are detached, the open socket set tracks them
+        std::thread(serve_connection, std::ref(state), socketFd).detach();
+    }
+
+    // Stop reading new commands, queued jobs still finish and reply
+    {
+        std::unique_lock<std::mutex> socketLock(state.socketMutex);
+        for (int socketFd : state.openSockets)
+        {
+            shutdown(socketFd, SHUT_RD);
+        }
+        state.socketCondition.wait(socketLock, [&]() { return state.openSockets.empty(); });
+    }
+    close(listenFd);
+    unlink(socketPath.c_str());
+    std::cout << "Server stopped\n";
+    return state.isStopping;
+}
@@ -0,0 +1,35 @@
+#ifndef __SERVER_H__
+#define __SERVER_H__
+
+#include <string>
+
+#include "RunOptions.h"
+
+/*
+* Server constraints
+*/
+// Pending connections on the listening socket
+#define SERVERBACKLOG 64
+// Bytes read from a connection per recv call
+#define SERVERREADSIZE 4096
+
+/*
+* Function to run sa as a daemon on a Unix domain socket
+* @param socketPath -> path of the socket to create (replaced if it exists)
+* @param defaultOptions -> options every job starts from
+* @return bool if the server ran until a shutdown request
+*
+* Protocol (one command per line, jobs can be pipelined on one connection):
+*   job <job_id> [options]   start a job, options as on the command line
+*   library <module_file>    add the modules of a file (parsed once, kept warm)
+*   module <module line>     add one module in the input file format
+*   end                      queue the job on the worker pool
+*   shutdown                 stop accepting, finish the queued jobs and exit
+* Replies (in job completion order):
+*   accepted <job_id>
+*   result <job_id> <solver> <area> <runtime_s> <polish expression>
+*   error <job_id> <message>
+*/
+bool run_server(const std::string& socketPath, const runOptions_t& defaultOptions);
+
+#endif // !__SERVER_H__
@@ -0,0 +1,302 @@
+
+#include <algorithm>
+#include <cmath>
+
+#include "ShapeCurve.h"
+#include "PolishExpression.h"
+
+/*
+* Comparator function for ordering curve points by width
+*/
+static bool compare_width(const shapePoint_t& point1, const shapePoint_t& point2)
+{
+    if (point1.width != point2.width)
+    {
+        return point1.width < point2.width;
+    }
+    return point1.height < point2.height;
+}
+
+/*
+* Function to append the shape curve of a module to the point pool
+* @param moduleStore -> module details table
+* @param id -> module ID
+* @param pointPool -> pool to append the curve to
+* @return number of points added
+*
+* Hard module => 1 point, rotatable => 2 points
+* Soft module => SOFTSHAPEPOINTS samples of w*h = area between the aspect ratio bounds
+*/
+int build_leaf_curve(const ModuleStore& moduleStore, int id, std::vector<shapePoint_t>& pointPool)
+{
+    int start = (int)pointPool.size();
+    float area = moduleStore.area(id);
+    float minRatio = moduleStore.min_aspect_ratio(id);
+    float maxRatio = moduleStore.max_aspect_ratio(id);
+    shapePoint_t currPoint;
+    currPoint.choice1 = currPoint.choice2 = -1;
+    if (minRatio < maxRatio)
+    {
+        // Soft module => geometric sampling of aspect ratio (w/h)
+        float ratioStep = std::pow(maxRatio / minRatio, 1.0f / (SOFTSHAPEPOINTS - 1));
+        float currRatio = minRatio;
+        for (int i = 0; i < SOFTSHAPEPOINTS; ++i)
+        {
+            currPoint.width = std::sqrt(area * currRatio);
+            currPoint.height = std::sqrt(area / currRatio);
+            pointPool.push_back(currPoint);
+            currRatio *= ratioStep;
+        }
+    }
+    else
+    {
+        // Hard module
+        currPoint.width = moduleStore.width(id);
+        currPoint.height = moduleStore.height(id);
+        pointPool.push_back(currPoint);
+    }
+    if (moduleStore.is_rotatable(id))
+    {
+        // Add the 90 degree rotated shapes
+        int end = (int)pointPool.size();
+        for (int i = start; i < end; ++i)
+        {
+            shapePoint_t rotatedPoint = pointPool[i];
+            std::swap(rotatedPoint.width, rotatedPoint.height);
+            pointPool.push_back(rotatedPoint);
+        }
+    }
+    std::sort(pointPool.begin() + start, pointPool.end(), compare_width);
+    return prune_curve(pointPool, start);
+}
+
+/*
+* Function to merge two child curves into the room curve (Stockmeyer)
+* @param pointPool -> pool holding child curves, room curve is appended to it
+* @param node1 -> curve node of child 1
+* @param node2 -> curve node of child 2
+* @param isHorizontal -> partition type of room
+* @return number of points added
+*
+* Logic: Linear time merge. For V, walk both curves from the narrowest point
+* and always advance the curve setting the max height. For H, walk from the
+* lowest point and advance the curve setting the max width.
+*/
+int merge_curves(std::vector<shapePoint_t>& pointPool, const curveNode_t& node1, const curveNode_t& node2, bool isHorizontal)
+{
+    int start = (int)pointPool.size();
+    shapePoint_t currPoint;
+    if (!isHorizontal)
+    {
+        // V_t: widths add, heights max
+        int i = 0, j = 0;
+        while (i < node1.size && j < node2.size)
+        {
+            const shapePoint_t point1 = pointPool[node1.start + i];
+            const shapePoint_t point2 = pointPool[node2.start + j];
+            currPoint.width = point1.width + point2.width;
+            currPoint.height = std::max(point1.height, point2.height);
+            currPoint.choice1 = i;
+            currPoint.choice2 = j;
+            pointPool.push_back(currPoint);
+            // Only reducing the taller child can reduce the height
+            if (point1.height > point2.height)
+            {
+                ++i;
+            }
+            else if (point1.height < point2.height)
+            {
+                ++j;
+            }
+            else
+            {
+                ++i;
+                ++j;
+            }
+        }
+    }
+    else
+    {
+        // H_t: heights add, widths max
+        int i = node1.size - 1, j = node2.size - 1;
+        while (i >= 0 && j >= 0)
+        {
+            const shapePoint_t point1 = pointPool[node1.start + i];
+            const shapePoint_t point2 = pointPool[node2.start + j];
+            currPoint.width = std::max(point1.width, point2.width);
+            currPoint.height = point1.height + point2.height;
+            currPoint.choice1 = i;
+            currPoint.choice2 = j;
+            pointPool.push_back(currPoint);
+            // Only reducing the wider child can reduce the width
+            if (point1.width > point2.width)
+            {
+                --i;
+            }
+            else if (point1.width < point2.width)
+            {
+                --j;
+            }
+            else
+            {
+                --i;
+                --j;
+            }
+        }
+        // Points were generated with decreasing width
+        std::reverse(pointPool.begin() + start, pointPool.end());
+    }
+    return prune_curve(pointPool, start);
+}
+
+/*
+* Function to remove dominated points and bound the size of a curve
+* @param pointPool -> pool holding the curve (curve is at the end of pool)
+* @param start -> index of first point of curve
+* @return number of points left
+*
+* NOTE: Curve must be sorted with width increasing
+*/
+int prune_curve(std::vector<shapePoint_t>& pointPool, int start)
+{
+    // Keep a point only if it is lower than every narrower point
+    int keep = start;
+    for (int i = start; i < (int)pointPool.size(); ++i)
+    {
+        if (keep > start && pointPool[i].height >= pointPool[keep - 1].height)
+        {
+            continue;
+        }
+        if (keep > start && pointPool[i].width == pointPool[keep - 1].width)
+        {
+            // Same width, lower height => replace
+            pointPool[keep - 1] = pointPool[i];
+            continue;
+        }
+        pointPool[keep++] = pointPool[i];
+    }
+    int size = keep - start;
+    if (size > MAXSHAPEPOINTS)
+    {
+        // Keep evenly spaced points along the curve (both ends included)
+        for (int i = 0; i < MAXSHAPEPOINTS; ++i)
+        {
+            pointPool[start + i] = pointPool[start + (int)((long long)i * (size - 1) / (MAXSHAPEPOINTS - 1))];
+        }
+        size = MAXSHAPEPOINTS;
+    }
+    pointPool.resize(start + size);
+    return size;
+}
+
+/*
+* Function to compute the area through the tree using shape curves
+* @param currList: current expression
+* @param moduleStore: module details table
+* @param generatePlotData: if plot data needs to be generated for python script
+* @param outline: fixed outline (NULL => none), root point picked by outline cost
+* @param outChipBox: chip box of the chosen root point (NULL => not needed)
+* @return float of minimum area (outline cost) on the root curve
+*
+* NOTE: With generatePlotData, the chosen shape of each module is written
+* back to the module store along with its placement
+*
+* Logic: Same post-order stack walk as compute_area_wrapper with the (w,h) pair
+* replaced by the shape curve of the node. The best root point is then traced back
+* top-down through the stored choices to get the shape and placement of each node.
+*/
+float compute_shape_area_wrapper(std::vector<std::string>& currList,
+    ModuleStore& moduleStore, bool generatePlotData, const fixedOutline_t* outline, chipBox_t* outChipBox)
+{
+    std::vector<curveNode_t> nodeList(currList.size());
+    std::vector<shapePoint_t> pointPool;
+    pointPool.reserve(4 * currList.size());
+    std::vector<int> nodeStack;
+    nodeStack.reserve(currList.size());
+    for (int index = 0; index < (int)currList.size(); ++index)
+    {
+        const std::string& currElement = currList[index];
+        curveNode_t& currNode = nodeList[index];
+        currNode.start = (int)pointPool.size();
+        if (is_operator(currElement))
+        {
+            // element is operator
+            // Pop two elements
+            currNode.child2 = nodeStack.back();
+            nodeStack.pop_back();
+            currNode.child1 = nodeStack.back();
+            nodeStack.pop_back();
+            currNode.moduleId = -1;
+            currNode.isHorizontal = is_horizontal_partition(currElement);
+            currNode.size = merge_curves(pointPool, nodeList[currNode.child1], nodeList[currNode.child2], currNode.isHorizontal);
+        }
+        else
+        {
+            // element is operand => build the module curve
+            currNode.moduleId = moduleStore.find_id(currElement);
+            currNode.size = build_leaf_curve(moduleStore, currNode.moduleId, pointPool);
+        }
+        nodeStack.push_back(index);
+    }
+
+    // Best chip shape on the root curve
+    const curveNode_t& topRoom = nodeList[nodeStack.back()];
+    int bestPoint = 0;
+    float totalArea = 0;
+    for (int i = 0; i < topRoom.size; ++i)
+    {
+        const shapePoint_t& currPoint = pointPool[topRoom.start + i];
+        float pointCost = outline ? outline_cost(currPoint.width, currPoint.height, *outline) : currPoint.width * currPoint.height;
+        if (i == 0 || pointCost < totalArea)
+        {
+            totalArea = pointCost;
+            bestPoint = i;
+        }
+    }
+    if (outChipBox)
+    {
+        outChipBox->width = pointPool[topRoom.start + bestPoint].width;
+        outChipBox->height = pointPool[topRoom.start + bestPoint].height;
+    }
+
+    if (generatePlotData)
+    {
+        // Chosen point and placement per node, pushed from the root (last index) down
+        std::vector<int> chosenPoint(currList.size(), 0);
+        std::vector<float> xList(currList.size(), 0), yList(currList.size(), 0);
+        chosenPoint[nodeStack.back()] = bestPoint;
+        moduleStore.clear_placement();
+
+        for (int i = (int)nodeList.size() - 1; i >= 0; --i)
+        {
+            const curveNode_t& currentRoom = nodeList[i];
+            const shapePoint_t& currPoint = pointPool[currentRoom.start + chosenPoint[i]];
+            if (currentRoom.moduleId != -1)
+            {
+                // Update the shape and placement in module store
+                moduleStore.set_dimensions(currentRoom.moduleId, currPoint.width, currPoint.height);
+                moduleStore.set_placement(currentRoom.moduleId, xList[i], yList[i]);
+                continue;
+            }
+            chosenPoint[currentRoom.child1] = currPoint.choice1;
+            chosenPoint[currentRoom.child2] = currPoint.choice2;
+            const shapePoint_t& point1 = pointPool[nodeList[currentRoom.child1].start + currPoint.choice1];
+            // Module 1 is either the left or bottom irrespective of partition
+            xList[currentRoom.child1] = xList[i];
+            yList[currentRoom.child1] = yList[i];
+            if (currentRoom.isHorizontal)
+            {
+                // H_t
+                xList[currentRoom.child2] = xList[i];
+                yList[currentRoom.child2] = yList[i] + point1.height;
+            }
+            else // V_t
+            {
+                xList[currentRoom.child2] = xList[i] + point1.width;
+                yList[currentRoom.child2] = yList[i];
+            }
+        }
+    }
+
+    return totalArea;
+}
@@ -0,0 +1,100 @@
+#ifndef __SHAPE_CURVE_H__
+#define __SHAPE_CURVE_H__
+
+#include <vector>
+#include <string>
+
+#include "ModuleStore.h"
+#include "FixedOutline.h"
+
+/*
+* Shape curve constraints
+*/
+// Number of sample points on the curve of a soft module (per orientation)
+#define SOFTSHAPEPOINTS 8
+// Maximum points kept on any curve after pruning
+#define MAXSHAPEPOINTS 64
+
+/*
+* Type for one corner point of a shape curve
+*
+* Curves are held with width strictly increasing and height
+* strictly decreasing (only non-dominated points)
+*/
+typedef struct shapePoint_t
+{
+    float width;
+    float height;
+    // Index of the point used from child1/child2 curve (room only)
+    int choice1;
+    int choice2;
+} shapePoint_t;
+
+/*
+* Type for the nodes of the slicing tree built
+* in the compute_shape_area_wrapper function
+*/
+typedef struct curveNode_t
+{
+    // Location of curve in the point pool
+    int start;
+    int size;
+    // Module ID if leaf, -1 if room
+    int moduleId;
+    // Child node indices (room only)
+    int child1;
+    int child2;
+    // If room is horizontal partition
+    bool isHorizontal;
+} curveNode_t;
+
+/*
+* Function to append the shape curve of a module to the point pool
+* @param moduleStore -> module details table
+* @param id -> module ID
+* @param pointPool -> pool to append the curve to
+* @return number of points added
+*
+* Hard module => 1 point, rotatable => 2 points
+* Soft module => SOFTSHAPEPOINTS samples of w*h = area between the aspect ratio bounds
+*/
+int build_leaf_curve(const ModuleStore& moduleStore, int id, std::vector<shapePoint_t>& pointPool);
+
+/*
+* Function to merge two child curves into the room curve (Stockmeyer)
+* @param pointPool -> pool holding child curves, room curve is appended to it
+* @param node1 -> curve node of child 1
+* @param node2 -> curve node of child 2
+* @param isHorizontal -> partition type of room
+* @return number of points added
+*
+* Logic: Linear time merge. For V, walk both curves from the narrowest point
+* and always advance the curve setting the max height. For H, walk from the
+* lowest point and advance the curve setting the max width.
+*/
+int merge_curves(std::vector<shapePoint_t>& pointPool, const curveNode_t& node1, const curveNode_t& node2, bool isHorizontal);
+
+/*
+* Function to remove dominated points and bound the size of a curve
+* @param pointPool -> pool holding the curve (curve is at the end of pool)
+* @param start -> index of first point of curve
+* @return number of points left
+*/
+int prune_curve(std::vector<shapePoint_t>& pointPool, int start);
+
+/*
+* Function to compute the area through the tree using shape curves
+* @param currList: current expression
+* @param moduleStore: module details table
+* @param generatePlotData: if plot data needs to be generated for python script
+* @param outline: fixed outline (NULL => none), root point picked by outline cost
+* @param outChipBox: chip box of the chosen root point (NULL => not needed)
+* @return float of minimum area (outline cost) on the root curve
+*
+* NOTE: With generatePlotData, the chosen shape of each module is written
+* back to the module store along with its placement
+*/
+float compute_shape_area_wrapper(std::vector<std::string>& currList,
+    ModuleStore& moduleStore, bool generatePlotData, const fixedOutline_t* outline = NULL, chipBox_t* outChipBox = NULL);
+
+#endif // !__SHAPE_CURVE_H__
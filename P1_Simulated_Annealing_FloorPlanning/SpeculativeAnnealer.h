@@ -0,0 +1,374 @@
+#ifndef __SPECULATIVE_ANNEALER_H__
+#define __SPECULATIVE_ANNEALER_H__
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+#include "Annealer.h"
+
+/*
+* Simulated annealing driver evaluating several moves of one chain at once
+*
+* Each batch proposes proposalCount moves from the current state (move types and
+* Metropolis random numbers drawn in proposal order), evaluates them on worker
+* threads, each on its own replica of the state, and replays the serial loop over the
+* results: proposals are rejected in order up to the first accepted one, which is
+* committed, the rest is discarded. Proposals from one state are independent, so the
+* accepted sequence has the same statistics as the serial chain of Annealer; only
+* the work of the discarded proposals is wasted (little at low temperature where
+* almost every move is rejected).
+*
+* Same policies as Annealer, Representation must also be copyable (one replica per
+* proposal). No profiler, move trace or step hook. Batches hand off through a
+* condition variable => only worth it when one evaluation takes much longer than
+* a thread wake up (large designs).
+*/
+template <typename Representation, typename CostPolicy = AreaCost,
+    typename CoolingPolicy = GeometricCooling, typename RandomEngine = std::default_random_engine,
+    typename MovePolicy = ScheduledMoves>
+class SpeculativeAnnealer
+{
+private:
+
+    /*
+    * Type for one proposed move and its evaluation
+    */
+    typedef struct proposal_t
+    {
+        int moveType = 0;
+        // Largest accepted cost (bounded evaluation) or Metropolis random number
+        float costThreshold = 0;
+        float unitRandom = 0;
+        bool isApplied = false;
+        bool isAccepted = false;
+        float newCost = 0;
+        long long nanoseconds = 0;
+        // State after the move (accepted proposals only)
+        typename Representation::state_t newState;
+    } proposal_t;
+
+    // Expression being annealed (updated in place)
+    Representation& state;
+    annealConfig_t config;
+    int proposalCount;
+    CoolingPolicy coolingPolicy;
+    RandomEngine randGenerator;
+    MovePolicy movePolicy;
+    // Per proposal slot (slot 0 runs on the calling thread)
+    std::vector<Representation> replicaList;
+    std::vector<CostPolicy> costPolicyList;
+    std::vector<proposal_t> proposalList;
+    // Batch hand off to the workers
+    std::mutex batchMutex;
+    std::condition_variable batchCondition;
+    std::condition_variable doneCondition;
+    int batchNumber;
+    int pendingWorkers;
+    bool isStopping;
+    // State, cost and temperature of the running batch
+    const typename Representation::state_t* baseState;
+    float baseCost;
+    float baseTemperature;
+
+    /*
+    * Function to apply and evaluate the move of one slot on its replica
+    * @param slot -> proposal slot
+    */
+    void evaluate_proposal(int slot);
+
+    /*
+    * Function run by each worker: evaluate its slot for every batch until stopped
+    * @param slot -> proposal slot of the worker
+    */
+    void worker_loop(int slot);
+
+    /*
+    * Function to evaluate all proposals from one state
+    * @param inState -> state the moves start from
+    * @param inCost -> cost of inState
+    * @param temperature -> current temperature
+    */
+    void run_batch(const typename Representation::state_t& inState, float inCost, float temperature);
+
+public:
+
+    /*
+    * Constructor
+    * @param inState -> expression to anneal, holds best solution after run
+    * @param inConfig -> run configuration
+    * @param inProposalCount -> moves evaluated per batch (threads used)
+    */
+    SpeculativeAnnealer(Representation& inState, const annealConfig_t& inConfig, int inProposalCount)
+        : state(inState), config(inConfig), proposalCount(std::max(1, inProposalCount)), coolingPolicy(inConfig),
+        movePolicy(Representation::moveTypeCount)
+    {
+        this->batchNumber = 0;
+        this->pendingWorkers = 0;
+        this->isStopping = false;
+        this->baseState = NULL;
+        this->baseCost = 0;
+        this->baseTemperature = 0;
+        std::random_device rd;
+        this->randGenerator.seed((this->config.seed != 0) ? this->config.seed : rd());
+        for (int slot = 0; slot < this->proposalCount; ++slot)
+        {
+            this->replicaList.push_back(inState);
+            // Different stream for the moves of each slot
+            this->replicaList[slot].set_seed((this->config.seed != 0) ? this->config.seed + 1 + slot : rd());
+            this->costPolicyList.push_back(CostPolicy(inConfig));
+        }
+        this->proposalList.resize(this->proposalCount);
+    }
+
+    SpeculativeAnnealer(const SpeculativeAnnealer&) = delete;
+    SpeculativeAnnealer& operator=(const SpeculativeAnnealer&) = delete;
+
+    /*
+    * Getter for the move policy
+    */
+    MovePolicy& get_move_policy() { return this->movePolicy; }
+
+    /*
+    * Function to run the annealing
+    * @return result of the run, state is left at the best solution
+    */
+    annealResult_t run();
+};
+
+/*
+* Function to apply and evaluate the move of one slot on its replica
+* @param slot -> proposal slot
+*/
+template <typename Representation, typename CostPolicy, typename CoolingPolicy, typename RandomEngine,
+    typename MovePolicy>
+void SpeculativeAnnealer<Representation, CostPolicy, CoolingPolicy, RandomEngine, MovePolicy>::evaluate_proposal(int slot)
+{
+    Representation& replica = this->replicaList[slot];
+    proposal_t& currProposal = this->proposalList[slot];
+    std::chrono::steady_clock::time_point moveStart = std::chrono::steady_clock::now();
+    replica.restore_state(*this->baseState);
+    currProposal.isApplied = replica.apply_move(currProposal.moveType);
+    currProposal.isAccepted = false;
+    if (currProposal.isApplied)
+    {
+        if (this->config.boundedEvaluation)
+        {
+            currProposal.newCost = this->costPolicyList[slot](replica, currProposal.costThreshold);
+            currProposal.isAccepted = (currProposal.newCost <= this->baseCost) || (currProposal.newCost < currProposal.costThreshold);
+        }
+        else
+        {
+            currProposal.newCost = this->costPolicyList[slot](replica);
+            float delCost = currProposal.newCost - this->baseCost;
+            currProposal.isAccepted = (delCost <= 0) || (currProposal.unitRandom < std::exp((-1 * delCost) / this->baseTemperature));
+        }
+        if (currProposal.isAccepted)
+        {
+            replica.save_state(currProposal.newState);
+        }
+    }
+    currProposal.nanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - moveStart).count();
+}
+
+/*
+* Function run by each worker: evaluate its slot for every batch until stopped
+* @param slot -> proposal slot of the worker
+*/
+template <typename Representation, typename CostPolicy, typename CoolingPolicy, typename RandomEngine,
+    typename MovePolicy>
+void SpeculativeAnnealer<Representation, CostPolicy, CoolingPolicy, RandomEngine, MovePolicy>::worker_loop(int slot)
+{
+    int seenBatch = 0;
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> batchLock(this->batchMutex);
+            this->batchCondition.wait(batchLock, [this, seenBatch]() { return this->isStopping || this->batchNumber != seenBatch; });
+            if (this->isStopping)
+            {
+                return;
+            }
+            seenBatch = this->batchNumber;
+        }
+        this->evaluate_proposal(slot);
+        std::lock_guard<std::mutex> batchLock(this->batchMutex);
+        if (--this->pendingWorkers == 0)
+        {
+            this->doneCondition.notify_one();
+        }
+    }
+}
+
+/*
+* Function to evaluate all proposals from one state
+* @param inState -> state the moves start from
+* @param inCost -> cost of inState
+* @param temperature -> current temperature
+*/
+template <typename Representation, typename CostPolicy, typename CoolingPolicy, typename RandomEngine,
+    typename MovePolicy>
+void SpeculativeAnnealer<Representation, CostPolicy, CoolingPolicy, RandomEngine, MovePolicy>::run_batch(
+    const typename Representation::state_t& inState, float inCost, float temperature)
+{
+    {
+        std::lock_guard<std::mutex> batchLock(this->batchMutex);
+        this->baseState = &inState;
+        this->baseCost = inCost;
+        this->baseTemperature = temperature;
+        this->pendingWorkers = this->proposalCount - 1;
+        ++this->batchNumber;
+    }
+    this->batchCondition.notify_all();
+    this->evaluate_proposal(0);
+    std::unique_lock<std::mutex> batchLock(this->batchMutex);
+    this->doneCondition.wait(batchLock, [this]() { return this->pendingWorkers == 0; });
+}
+
+/*
+* Function to run the annealing
+* @return result of the run, state is left at the best solution
+*
+* Logic: Same temperature steps, counters and stop conditions as Annealer::run, with the
+* inner loop consuming the batch results in proposal order
+*/
+template <typename Representation, typename CostPolicy, typename CoolingPolicy, typename RandomEngine,
+    typename MovePolicy>
+annealResult_t SpeculativeAnnealer<Representation, CostPolicy, CoolingPolicy, RandomEngine, MovePolicy>::run()
+{
+    annealResult_t result;
+    std::uniform_int_distribution<int> percentDistribution(0, 99);
+    std::uniform_real_distribution<float> unitDistribution(0.0f, 1.0f);
+    std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+
+    typename Representation::state_t currState, bestState;
+    float currCost = this->costPolicyList[0](this->state);
+    float bestCost = currCost;
+    this->state.save_state(currState);
+    bestState = currState;
+    result.initialCost = currCost;
+    result.costCurve.push_back({ 0, currCost });
+
+    // Moves per temperature scale with the modules the moves can touch
+    int maxRuns = this->config.runMultiplier * this->state.get_move_module_count();
+    float temperature = this->config.initialTemperature;
+    float runTime = 0;
+    int movesTried = 0, uphill = 0, reject = 0;
+    // Single module in the move window => M1 cannot run, no operator to move
+    bool canMove = this->state.get_module_count() > 1 && this->state.get_move_module_count() > 1;
+
+    std::vector<std::thread> workerList;
+    for (int slot = 1; slot < this->proposalCount; ++slot)
+    {
+        workerList.push_back(std::thread(&SpeculativeAnnealer::worker_loop, this, slot));
+    }
+
+    while (canMove)
+    {
+        movesTried = 0;
+        uphill = 0;
+        reject = 0;
+        bool isStepDone = false;
+        while (!isStepDone)
+        {
+            for (auto& currProposal : this->proposalList)
+            {
+                currProposal.moveType = this->movePolicy.select(temperature, this->config.initialTemperature,
+                    percentDistribution(this->randGenerator));
+                float unitRandom = unitDistribution(this->randGenerator);
+                // u = 0 => no bound (always accepted)
+                currProposal.costThreshold = currCost - temperature * std::log(unitRandom);
+                currProposal.unitRandom = unitRandom;
+            }
+            this->run_batch(currState, currCost, temperature);
+
+            // Serial loop over the results up to the first accepted move
+            for (int slot = 0; slot < this->proposalCount; ++slot)
+            {
+                proposal_t& currProposal = this->proposalList[slot];
+                if (!currProposal.isApplied)
+                {
+                    this->movePolicy.record(currProposal.moveType, false, false, 0, currProposal.nanoseconds);
+                    continue; // re-attempt move
+                }
+                ++movesTried;
+                float delCost = currProposal.newCost - currCost;
+                this->movePolicy.record(currProposal.moveType, true, currProposal.isAccepted, delCost, currProposal.nanoseconds);
+                if (currProposal.isAccepted)
+                {
+                    if (delCost > 0)
+                    {
+                        ++uphill;
+                    }
+                    currState.swap(currProposal.newState);
+                    currCost = currProposal.newCost;
+                    if (currCost < bestCost)
+                    {
+                        bestState = currState;
+                        bestCost = currCost;
+                        // Replica of the slot holds the accepted state
+                        result.targetMet = this->costPolicyList[slot].is_target_met(this->replicaList[slot], bestCost);
+                    }
+                }
+                else
+                {
+                    ++reject;
+                }
+                isStepDone = (uphill >= maxRuns) || (movesTried >= 2 * maxRuns) || result.targetMet;
+                // Later proposals started from the replaced state => discarded
+                if (isStepDone || currProposal.isAccepted)
+                {
+                    break;
+                }
+            }
+        }
+
+        // Update temperature
+        temperature = this->coolingPolicy(temperature);
+        this->movePolicy.end_step();
+        result.movesTried += movesTried;
+        ++result.attempts;
+        if (this->config.verbose)
+        {
+            std::cout << "Attempt #" << result.attempts << ": Cost Value = " << bestCost << "\n";
+        }
+
+        // Calcuate runtime for time out check
+        runTime = std::chrono::duration<float>(std::chrono::steady_clock::now() - startTime).count();
+        result.costCurve.push_back({ runTime, bestCost });
+        if (result.targetMet ||
+            ((float)reject / movesTried >= 0.95f) ||
+            (temperature <= this->config.tempConstraint) ||
+            (runTime >= 60 * this->config.timeOut))
+        {
+            break;
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> batchLock(this->batchMutex);
+        this->isStopping = true;
+    }
+    this->batchCondition.notify_all();
+    for (auto& worker : workerList)
+    {
+        worker.join();
+    }
+
+    this->state.restore_state(bestState);
+    result.bestExpression = this->state.get_polish_expression();
+    result.bestCost = bestCost;
+    result.moveStats = this->movePolicy.get_stats();
+    result.runTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    return result;
+}
+
+/*
+* Speculative slicing floorplan instantiations (schedule / adaptive move selection)
+*/
+typedef SpeculativeAnnealer<PolishExpression> SpeculativeSlicingAnnealer;
+typedef SpeculativeAnnealer<PolishExpression, AreaCost, GeometricCooling, std::default_random_engine, AdaptiveMoves> AdaptiveSpeculativeSlicingAnnealer;
+
+#endif // !__SPECULATIVE_ANNEALER_H__
@@ -0,0 +1,73 @@
+
+#include <algorithm>
+
+#include "ThreadPool.h"
+
+/*
+* Constructor
+* @param threadCount -> number of workers (0 => hardware concurrency)
+*/
+ThreadPool::ThreadPool(int threadCount)
+{
+    this->isStopping = false;
+    if (threadCount <= 0)
+    {
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+    for (int t = 0; t < threadCount; ++t)
+    {
+        this->workerList.push_back(std::thread(&ThreadPool::worker_loop, this));
+    }
+}
+
+/*
+* Destructor: finishes the queued tasks and joins the workers
+*/
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> queueLock(this->queueMutex);
+        this->isStopping = true;
+    }
+    this->queueCondition.notify_all();
+    for (auto& worker : this->workerList)
+    {
+        worker.join();
+    }
+}
+
+/*
+* Function to queue a task
+* @param inTask -> task to run on a worker
+*/
+void ThreadPool::submit(std::function<void()> inTask)
+{
+    {
+        std::lock_guard<std::mutex> queueLock(this->queueMutex);
+        this->taskQueue.push(std::move(inTask));
+    }
+    this->queueCondition.notify_one();
+}
+
+/*
+* Function run by each worker: take tasks until the pool stops
+*/
+void ThreadPool::worker_loop()
+{
+    while (true)
+    {
+        std::function<void()> currTask;
+        {
+            std::unique_lock<std::mutex> queueLock(this->queueMutex);
+            this->queueCondition.wait(queueLock, [this]() { return this->isStopping || !this->taskQueue.empty(); });
+            // Queue is drained before stopping
+            if (this->taskQueue.empty())
+            {
+                return;
+            }
+            currTask = std::move(this->taskQueue.front());
+            this->taskQueue.pop();
+        }
+        currTask();
+    }
+}
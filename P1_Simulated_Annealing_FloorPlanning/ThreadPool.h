@@ -0,0 +1,56 @@
+#ifndef __THREAD_POOL_H__
+#define __THREAD_POOL_H__
+
+#include <vector>
+#include <queue>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
+/*
+* Fixed size pool of worker threads running queued tasks in FIFO order
+*/
+class ThreadPool
+{
+private:
+    std::vector<std::thread> workerList;
+    std::queue<std::function<void()> > taskQueue;
+    std::mutex queueMutex;
+    std::condition_variable queueCondition;
+    bool isStopping;
+
+    /*
+    * Function run by each worker: take tasks until the pool stops
+    */
+    void worker_loop();
+
+public:
+
+    /*
+    * Constructor
+    * @param threadCount -> number of workers (0 => hardware concurrency)
+    */
+    explicit ThreadPool(int threadCount = 0);
+
+    /*
+    * Destructor: finishes the queued tasks and joins the workers
+    */
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /*
+    * Function to queue a task
+    * @param inTask -> task to run on a worker
+    */
+    void submit(std::function<void()> inTask);
+
+    /*
+    * Getter for the number of workers
+    */
+    int size() const { return (int)this->workerList.size(); }
+};
+
+#endif // !__THREAD_POOL_H__